@@ -55,6 +55,16 @@ unsigned int Complex<RealType, ImagType>::get_ascii_value() const {
     return ascii_sum;
 }
 
+/**
+ * @brief Compares two complex numbers part by part.
+ * @param other The complex number to compare with.
+ * @return True if both the real and the imaginary parts are equal.
+ */
+template <typename RealType, typename ImagType>
+bool Complex<RealType, ImagType>::operator==(const Complex& other) const {
+    return real == other.real && imag == other.imag;
+}
+
 // Explicit template instantiation definitions
 template class Complex<int, int>;
 template class Complex<int, double>;
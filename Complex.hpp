@@ -49,6 +49,13 @@ public:
      * @return The ASCII sum of the string representation.
      */
     unsigned int get_ascii_value() const;
+
+    /**
+     * @brief Compares two complex numbers part by part.
+     * @param other The complex number to compare with.
+     * @return True if both the real and the imaginary parts are equal.
+     */
+    bool operator==(const Complex& other) const;
 };
 
 
@@ -8,7 +8,27 @@
 #include "Complex.hpp"
 #include "node.hpp"
 #include "tree.hpp"
+#include "exporter.hpp"
+#include "generator.hpp"
+#include "ranges.hpp"
+#include "persistent_tree.hpp"
+#include "concurrent_tree.hpp"
+#include "concurrent_builder.hpp"
+#include "reclaimer.hpp"
+#include "alloc_stats.hpp"
+#include "perf_counters.hpp"
+#include "trace.hpp"
+#include "node_heap.hpp"
+#include "complete_tree.hpp"
+#include "key_sort.hpp"
 #include <memory>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <numeric>
+#include <chrono>
+#include <limits>
 
 // Test default constructor for Complex
 TEST_CASE("Complex Default Constructor") {
@@ -317,7 +337,1316 @@ TEST_CASE("Tree maxDegree enforcement tests") {
 
 TEST_CASE("tree with degree more then 2 trying to make it a min heap"){
 
-    // Complex tree is with degree 4
+    // Complex tree is with degree 4, so the heap is 4-ary
     Tree tree = create_complex_tree();
-    CHECK_THROWS(tree.myHeap());
-}
\ No newline at end of file
+    Tree heapTree;
+    CHECK_NOTHROW(heapTree = tree.myHeap());
+    CHECK(heapTree.get_max_degree() == 4);
+
+    // Every node keeps its value and no child comes before its parent
+    std::vector<std::string> original, heap;
+    for (auto node_ptr : tree) {
+        original.push_back(node_ptr->get_value());
+    }
+    for (auto node_ptr : heapTree) {
+        heap.push_back(node_ptr->get_value());
+    }
+    std::sort(original.begin(), original.end());
+    std::sort(heap.begin(), heap.end());
+    CHECK((heap == original));
+    for (auto it = heapTree.begin_bfs(); it != heapTree.end_bfs(); ++it) {
+        CHECK((*it)->children.size() <= 4);
+        for (const auto& child : (*it)->children) {
+            CHECK((*it)->get_ascii_value() <= child->get_ascii_value());
+        }
+    }
+
+    // 12 nodes in a complete 4-ary heap: the root has 4 children, which have 4, 3, 0 and 0
+    BaseNode* root = heapTree.get_root();
+    CHECK(root->children.size() == 4);
+    CHECK(root->children[0]->children.size() == 4);
+    CHECK(root->children[1]->children.size() == 3);
+    CHECK(root->children[2]->children.empty());
+    CHECK(heapTree.height() == 2);
+
+    // A tree of degree 0 has no arity to build a heap with, even around a prebuilt root
+    auto prebuilt = std::make_shared<Node<int>>(1);
+    prebuilt->add_child(std::make_shared<Node<int>>(2));
+    Tree flat(0);
+    flat.add_root(prebuilt);
+    CHECK_THROWS_WITH_AS(flat.myHeap(), "Error: Heap arity must be at least 1!", std::runtime_error);
+}
+
+// Test the DOT exporter
+TEST_CASE("Tree DOT export tests") {
+    Tree tree = create_another_sample_tree();
+    std::ostringstream out;
+    TreeExporter::write_dot(tree, out);
+    std::string dot = out.str();
+
+    // Nodes are numbered in pre-order and every edge points from parent to child
+    CHECK(dot.rfind("digraph Tree {", 0) == 0);
+    CHECK(dot.find("n0 [label=\"root2\"];") != std::string::npos);
+    CHECK(dot.find("n1 [label=\"10\"];") != std::string::npos);
+    CHECK(dot.find("n0 -> n1;") != std::string::npos);
+    CHECK(dot.find("n0 -> n4;") != std::string::npos);
+    CHECK(dot.find("n5 -> n6;") != std::string::npos);
+    CHECK(dot.find("n7 -> n8;") != std::string::npos);
+
+    // An empty tree still produces a valid graph
+    Tree empty;
+    std::ostringstream emptyOut;
+    TreeExporter::write_dot(empty, emptyOut);
+    CHECK(emptyOut.str() == "digraph Tree {\n    node [shape=circle, style=filled, fillcolor=black, fontcolor=white];\n}\n");
+}
+
+// Test the SVG exporter
+TEST_CASE("Tree SVG export tests") {
+    Tree tree = create_sample_tree();
+    std::ostringstream out;
+    TreeExporter::write_svg(tree, out);
+    std::string svg = out.str();
+
+    // One circle per node and one line per edge
+    size_t circles = 0;
+    size_t lines = 0;
+    for (size_t pos = svg.find("<circle"); pos != std::string::npos; pos = svg.find("<circle", pos + 1)) circles++;
+    for (size_t pos = svg.find("<line"); pos != std::string::npos; pos = svg.find("<line", pos + 1)) lines++;
+    CHECK(circles == 9);
+    CHECK(lines == 8);
+
+    // The root is centered at the top of the canvas like in the GUI
+    CHECK(svg.find("<circle cx=\"400\" cy=\"50\"") != std::string::npos);
+    CHECK(svg.find(">7-4.5i</text>") != std::string::npos);
+}
+
+// Test the Euler-tour index queries
+TEST_CASE("Tree Euler index tests") {
+    Tree tree = create_sample_tree();
+    BaseNode* root = tree.get_root();
+    BaseNode* n1 = root->children[0].get();
+    BaseNode* n2 = root->children[1].get();
+    BaseNode* n5 = n1->children[1].get();
+    BaseNode* n8 = n5->children[0].get();
+
+    // Subtree sizes
+    CHECK(tree.subtree_size(root) == 9);
+    CHECK(tree.subtree_size(n1) == 4);
+    CHECK(tree.subtree_size(n2) == 3);
+    CHECK(tree.subtree_size(n8) == 1);
+
+    // Ancestor checks
+    CHECK(tree.is_ancestor(root, n8));
+    CHECK(tree.is_ancestor(n1, n8));
+    CHECK(tree.is_ancestor(n8, n8));
+    CHECK_FALSE(tree.is_ancestor(n2, n8));
+    CHECK_FALSE(tree.is_ancestor(n8, n1));
+
+    // Entry/exit times and depths
+    const EulerIndex& index = tree.euler_index();
+    CHECK(index.size() == 9);
+    CHECK(index.entry(index.id_of(n1)) == 1);
+    CHECK(index.exit(index.id_of(n1)) == 4);
+    CHECK(index.depth(n8) == 3);
+
+    // Adding a node invalidates the index
+    auto n9 = std::make_shared<Node<int>>(9);
+    tree.add_sub_node(n8, n9);
+    CHECK(tree.subtree_size(n1) == 5);
+    CHECK(tree.is_ancestor(n5, n9.get()));
+
+    // Unknown nodes are rejected
+    Node<int> stranger(0);
+    CHECK_THROWS_AS(tree.subtree_size(&stranger), std::runtime_error);
+}
+
+// Test the lowest common ancestor queries
+TEST_CASE("Tree LCA tests") {
+    Tree tree = create_complex_tree();
+    BaseNode* root = tree.get_root();
+    BaseNode* n1 = root->children[0].get();
+    BaseNode* n2 = root->children[1].get();
+    BaseNode* n5 = n1->children[0].get();
+    BaseNode* n6 = n1->children[1].get();
+    BaseNode* n7 = n2->children[0].get();
+    BaseNode* n8 = n2->children[1].get();
+    BaseNode* n11 = n8->children[0].get();
+
+    CHECK(tree.lca(n5, n6) == n1);
+    CHECK(tree.lca(n7, n11) == n2);
+    CHECK(tree.lca(n11, n7) == n2);
+    CHECK(tree.lca(n5, n11) == root);
+    CHECK(tree.lca(n8, n11) == n8);
+    CHECK(tree.lca(n6, n6) == n6);
+
+    // Batched queries keep the order of the pairs
+    std::vector<BaseNode*> batch = tree.lca_batch({{n5, n6}, {n7, n11}, {n1, root}});
+    CHECK((batch == std::vector<BaseNode*>{n1, n2, root}));
+
+    Node<int> stranger(0);
+    CHECK_THROWS_AS(tree.lca(n5, &stranger), std::runtime_error);
+}
+
+// Test the incremental LCA index against the sparse table on a growing path
+TEST_CASE("Tree incremental LCA tests") {
+    Tree tree(2);
+    auto root_node = std::make_shared<Node<int>>(0);
+    tree.add_root(root_node);
+    tree.enable_incremental_lca();
+
+    // Build a long left spine with a right leaf hanging off every spine node
+    std::vector<BaseNode*> spine = {root_node.get()};
+    std::vector<BaseNode*> leaves;
+    for (int i = 1; i <= 40; ++i) {
+        auto next = std::make_shared<Node<int>>(i);
+        auto leaf = std::make_shared<Node<int>>(-i);
+        tree.add_sub_node(spine.back(), next);
+        tree.add_sub_node(spine.back(), leaf);
+        spine.push_back(next.get());
+        leaves.push_back(leaf.get());
+    }
+
+    // Answered by binary lifting since the sparse table was never built
+    CHECK(tree.lca(spine[40], leaves[9]) == spine[9]);
+    CHECK(tree.lca(leaves[30], leaves[3]) == spine[3]);
+    CHECK(tree.lca(spine[17], spine[33]) == spine[17]);
+
+    // Both indexes must agree once the sparse table is also available
+    IncrementalLca lifting(tree.get_root());
+    LcaIndex table(std::make_shared<EulerIndex>(tree.get_root()));
+    for (size_t i = 0; i < leaves.size(); i += 3) {
+        for (size_t j = 0; j < spine.size(); j += 5) {
+            CHECK(lifting.lca(leaves[i], spine[j]) == table.lca(leaves[i], spine[j]));
+        }
+    }
+}
+
+// Test the value lookups
+TEST_CASE("Tree value index tests") {
+    Tree tree = create_sample_tree();
+    BaseNode* root = tree.get_root();
+    BaseNode* n1 = root->children[0].get();
+
+    CHECK((tree.find_by_value("root") == std::vector<BaseNode*>{root}));
+    CHECK((tree.find_by_value("1") == std::vector<BaseNode*>{n1}));
+    CHECK(tree.find_by_value("missing").empty());
+
+    // Nodes added later are indexed, duplicates are kept in insertion order
+    auto dup = std::make_shared<Node<std::string>>("1");
+    tree.add_sub_node(root->children[2].get(), dup);
+    CHECK((tree.find_by_value("1") == std::vector<BaseNode*>{n1, dup.get()}));
+
+    // Typed lookups only match nodes of the same type
+    CHECK((tree.find_typed(1) == std::vector<BaseNode*>{n1}));
+    CHECK((tree.find_typed(std::string("1")) == std::vector<BaseNode*>{dup.get()}));
+    CHECK(tree.find_typed(Complex<int, double>(7, -4.5)).size() == 1);
+
+    // Doubles that print the same share a bucket but are told apart by value
+    auto close = std::make_shared<Node<double>>(12.351);
+    tree.add_sub_node(root->children[2].get(), close);
+    CHECK(tree.find_by_value(close->get_value()).size() == 2);
+    CHECK((tree.find_typed(12.351) == std::vector<BaseNode*>{close.get()}));
+    CHECK(tree.find_typed(12.349).empty());
+    CHECK(tree.find_typed(12.35).size() == 1);
+
+    // Batched lookups keep the order of the values
+    auto batch = tree.find_by_values({"n5", "missing", "12.35"});
+    CHECK(batch.size() == 3);
+    CHECK(batch[0].size() == 1);
+    CHECK(batch[1].empty());
+    CHECK(batch[2].size() == 2);
+
+    // Replacing the root re-indexes the tree
+    tree.add_root(std::make_shared<Node<std::string>>("new root"));
+    CHECK(tree.find_by_value("root").empty());
+    CHECK(tree.find_by_value("new root").size() == 1);
+}
+
+// Test the level queries
+TEST_CASE("Tree level index tests") {
+    Tree tree = create_complex_tree();
+
+    // Collect the values of one level
+    auto level_values = [&tree](size_t depth) {
+        std::vector<std::string> values;
+        for (BaseNode* node : tree.nodes_at_depth(depth)) {
+            values.push_back(node->get_value());
+        }
+        return values;
+    };
+
+    CHECK((level_values(0) == std::vector<std::string>{"complex"}));
+    CHECK((level_values(1) == std::vector<std::string>{"1+2.5i", "3.14+7i", "5-1.5i", "2.71+3i"}));
+    CHECK((level_values(2) == std::vector<std::string>{"42", "6.28", "n7", "n8", "n9", "-3+1.1i"}));
+    CHECK((level_values(3) == std::vector<std::string>{"10+2.2i"}));
+    CHECK(tree.nodes_at_depth(4).empty());
+    CHECK(tree.height() == 3);
+
+    BaseNode* n8 = tree.get_root()->children[1]->children[1].get();
+    CHECK(tree.depth_of(n8) == 2);
+
+    // The index is rebuilt after a mutation
+    auto n12 = std::make_shared<Node<int>>(12);
+    tree.add_sub_node(n8->children[0].get(), n12);
+    CHECK(tree.height() == 4);
+    CHECK(tree.depth_of(n12.get()) == 4);
+    CHECK(tree.nodes_at_depth(4).size() == 1);
+
+    // Empty tree
+    Tree empty;
+    CHECK(empty.height() == 0);
+    CHECK(empty.nodes_at_depth(0).empty());
+}
+
+// Helper function to collect the values produced by a generator
+std::vector<std::string> generator_values(TraversalGenerator& generator) {
+    std::vector<std::string> values;
+    for (BaseNode* node : generator) {
+        values.push_back(node->get_value());
+    }
+    return values;
+}
+
+// Helper function to collect the values visited by an iterator pair
+template <typename Iterator>
+std::vector<std::string> iterator_values(Iterator begin, Iterator end) {
+    std::vector<std::string> values;
+    for (auto it = begin; it != end; ++it) {
+        values.push_back((*it)->get_value());
+    }
+    return values;
+}
+
+// Test that generators produce the same sequences as the iterators
+TEST_CASE("Tree generator traversal tests") {
+    using Order = TraversalGenerator::Order;
+    for (Tree tree : {create_sample_tree(), create_another_sample_tree(), create_complex_tree()}) {
+        TraversalGenerator bfs(tree, Order::BFS);
+        TraversalGenerator dfs(tree, Order::DFS);
+        TraversalGenerator pre(tree, Order::PreOrder);
+        TraversalGenerator post(tree, Order::PostOrder);
+        TraversalGenerator in(tree, Order::InOrder);
+        CHECK((generator_values(bfs) == iterator_values(tree.begin_bfs(), tree.end_bfs())));
+        CHECK((generator_values(dfs) == iterator_values(tree.begin_dfs(), tree.end_dfs())));
+        CHECK((generator_values(pre) == iterator_values(tree.begin_pre_order(), tree.end_pre_order())));
+        CHECK((generator_values(post) == iterator_values(tree.begin_post_order(), tree.end_post_order())));
+        CHECK((generator_values(in) == iterator_values(tree.begin_in_order(), tree.end_in_order())));
+        CHECK(in.done());
+    }
+}
+
+// Test suspending, composing and interleaving generators
+TEST_CASE("Tree generator composition tests") {
+    using Order = TraversalGenerator::Order;
+    Tree tree = create_another_sample_tree();
+
+    // The traversal resumes where it was suspended
+    TraversalGenerator post(tree, Order::PostOrder);
+    CHECK(post.next()->get_value() == "20.45");
+    CHECK(post.next()->get_value() == "0.5");
+    CHECK((generator_values(post) == std::vector<std::string>{"10", "4.5+7i", "n5", "3-1.2i", "n6", "n2", "root2"}));
+    CHECK(post.next() == nullptr);
+
+    // Filters and limits are applied while traversing
+    TraversalGenerator strings(tree, Order::BFS);
+    strings.filter([](BaseNode* node) { return dynamic_cast<Node<std::string>*>(node) != nullptr; }).take(3);
+    CHECK((generator_values(strings) == std::vector<std::string>{"root2", "n2", "n5"}));
+
+    // Round-robin over two trees, two nodes at a time
+    std::vector<TraversalGenerator> generators;
+    Tree other = create_string_tree();
+    generators.emplace_back(tree, Order::PreOrder);
+    generators.emplace_back(other, Order::PreOrder);
+    std::vector<std::string> visited;
+    interleave(generators, 2, [&visited](size_t i, BaseNode* node) {
+        visited.push_back(std::to_string(i) + ":" + node->get_value());
+    });
+    CHECK(visited.size() == 17);
+    CHECK((std::vector<std::string>(visited.begin(), visited.begin() + 4) ==
+           std::vector<std::string>{"0:root2", "0:10", "1:node5", "1:node3"}));
+
+    // A quantum of 0 would never advance any generator
+    std::vector<TraversalGenerator> stalled;
+    stalled.emplace_back(tree, Order::BFS);
+    CHECK_THROWS_AS(interleave(stalled, 0, [](size_t, BaseNode*) {}), std::runtime_error);
+
+    // Finished generators return their buffers to the pool
+    FramePool pool;
+    {
+        TraversalGenerator first(tree, Order::DFS, pool);
+        generator_values(first);
+    }
+    CHECK(pool.idle() == 1);
+    {
+        TraversalGenerator second(tree, Order::DFS, pool);
+        CHECK(pool.idle() == 0);
+    }
+    CHECK(pool.idle() == 1);
+
+    // A generator without a pool can be finished and destroyed on another thread
+    TraversalGenerator moved(tree, Order::BFS);
+    moved.next();
+    std::vector<std::string> rest;
+    std::thread([&rest](TraversalGenerator generator) { rest = generator_values(generator); }, std::move(moved)).join();
+    CHECK(rest.size() == 8);
+}
+
+// Test the lazy range adaptors
+TEST_CASE("Tree range adaptor tests") {
+    Tree tree = create_complex_tree();
+
+    // Filter, transform and take compose into a single pass
+    std::vector<std::string> values;
+    for (const std::string& value : bfs_range(tree)
+                                    | filter([](BaseNode* node) { return node->children.empty(); })
+                                    | transform([](BaseNode* node) { return node->get_value(); })
+                                    | take(4)) {
+        values.push_back(value);
+    }
+    CHECK((values == std::vector<std::string>{"42", "6.28", "n7", "n9"}));
+
+    // Pruned subtrees are never visited
+    size_t checked = 0;
+    auto is_n2 = [&checked](BaseNode* node) {
+        checked++;
+        return node->get_value() == "3.14+7i";
+    };
+    values.clear();
+    for (BaseNode* node : pre_order_range(tree) | prune(is_n2)) {
+        values.push_back(node->get_value());
+    }
+    CHECK((values == std::vector<std::string>{"complex", "1+2.5i", "42", "6.28", "5-1.5i", "n9", "2.71+3i", "-3+1.1i"}));
+    CHECK(checked == 9);
+
+    // Pruning works level by level on BFS as well
+    values.clear();
+    for (BaseNode* node : bfs_range(tree) | prune(is_n2) | take(6)) {
+        values.push_back(node->get_value());
+    }
+    CHECK((values == std::vector<std::string>{"complex", "1+2.5i", "5-1.5i", "2.71+3i", "42", "6.28"}));
+}
+
+// Test skipping subtrees with the iterators
+TEST_CASE("Tree skip_children tests") {
+    Tree tree = create_sample_tree();
+
+    // Skip the subtree of "1" in every order that supports it
+    std::vector<std::string> pre;
+    for (auto it = tree.begin_pre_order(); it != tree.end_pre_order(); ++it) {
+        pre.push_back((*it)->get_value());
+        if ((*it)->get_value() == "1") it.skip_children();
+    }
+    CHECK((pre == std::vector<std::string>{"root", "1", "n2", "n6", "n7", "12.35"}));
+
+    std::vector<std::string> dfs;
+    for (auto it = tree.begin_dfs(); it != tree.end_dfs(); ++it) {
+        dfs.push_back((*it)->get_value());
+        if ((*it)->get_value() == "1") it.skip_children();
+    }
+    CHECK((dfs == pre));
+
+    std::vector<std::string> bfs;
+    for (auto it = tree.begin_bfs(); it != tree.end_bfs(); ++it) {
+        bfs.push_back((*it)->get_value());
+        if ((*it)->get_value() == "1") it.skip_children();
+    }
+    CHECK((bfs == std::vector<std::string>{"root", "1", "n2", "12.35", "n6", "n7"}));
+}
+
+// Test the early-exit search helpers
+TEST_CASE("Tree find_first and find_all tests") {
+    Tree tree = create_sample_tree();
+    auto is_string = [](BaseNode* node) { return dynamic_cast<Node<std::string>*>(node) != nullptr; };
+
+    size_t visited = 0;
+    auto count_and_match = [&visited](BaseNode* node) {
+        visited++;
+        return node->get_value() == "n5";
+    };
+    BaseNode* found = tree.find_first(count_and_match);
+    REQUIRE(found != nullptr);
+    CHECK(found->get_value() == "n5");
+    CHECK(visited == 4);  // The search stops at the match
+
+    CHECK(tree.find_first([](BaseNode* node) { return node->get_value() == "missing"; }) == nullptr);
+
+    // Search every string node, but only below the root and "n2"
+    std::vector<BaseNode*> strings = tree.find_all(is_string, [](BaseNode* node) {
+        return node->get_value() == "root" || node->get_value() == "n2";
+    });
+    std::vector<std::string> values;
+    for (BaseNode* node : strings) values.push_back(node->get_value());
+    CHECK((values == std::vector<std::string>{"root", "n2", "n6", "n7"}));
+    CHECK(tree.find_all(is_string).size() == 5);
+}
+
+// Test the persistent tree versions
+TEST_CASE("Persistent tree tests") {
+    PersistentTree history(2);
+    CHECK(history.latest().get_root() == nullptr);
+
+    size_t v1 = history.add_root(std::make_shared<Node<std::string>>("root"));
+    BaseNode* root1 = history.version(v1).get_root();
+    size_t v2 = history.add_sub_node(v1, root1, std::make_shared<Node<int>>(1));
+    size_t v3 = history.add_sub_node(v2, history.version(v2).get_root(), std::make_shared<Node<int>>(2));
+    size_t v4 = history.add_sub_node(v3, std::vector<size_t>{0}, std::make_shared<Node<double>>(1.5));
+    CHECK(history.latest_version() == v4);
+
+    // Old versions keep their structure
+    CHECK((iterator_values(history.version(v1).begin_bfs(), history.version(v1).end_bfs()) == std::vector<std::string>{"root"}));
+    CHECK((iterator_values(history.version(v2).begin_bfs(), history.version(v2).end_bfs()) == std::vector<std::string>{"root", "1"}));
+    CHECK((iterator_values(history.version(v3).begin_bfs(), history.version(v3).end_bfs()) == std::vector<std::string>{"root", "1", "2"}));
+    CHECK((iterator_values(history.latest().begin_bfs(), history.latest().end_bfs()) == std::vector<std::string>{"root", "1", "2", "1.5"}));
+
+    // Only the path to the changed node is copied, the sibling subtree is shared
+    BaseNode* root3 = history.version(v3).get_root();
+    BaseNode* root4 = history.version(v4).get_root();
+    CHECK(root3 != root4);
+    CHECK(root3->children[0] != root4->children[0]);
+    CHECK(root3->children[1] == root4->children[1]);
+
+    // Failed updates leave the history unchanged
+    Node<int> stranger(0);
+    CHECK_THROWS_AS(history.add_sub_node(v4, &stranger, std::make_shared<Node<int>>(3)), std::runtime_error);
+    CHECK_THROWS_AS(history.add_sub_node(v4, root4, std::make_shared<Node<int>>(3)), std::runtime_error);
+    CHECK_THROWS_AS(history.version(42), std::out_of_range);
+    CHECK(history.latest_version() == v4);
+}
+
+// Test the copy-on-write clone
+TEST_CASE("Tree copy-on-write clone tests") {
+    Tree original = create_another_sample_tree();
+    std::vector<std::string> before = iterator_values(original.begin_bfs(), original.end_bfs());
+    Tree copy = original.clone();
+
+    // Both trees share the same nodes until one of them changes
+    CHECK(copy.get_root() == original.get_root());
+
+    // Add a node deep in the clone, using a node found in the shared structure
+    BaseNode* n5 = original.get_root()->children[1]->children[0].get();
+    BaseNode* n6 = original.get_root()->children[1]->children[1].get();
+    copy.add_sub_node(n5, std::make_shared<Node<std::string>>("new"));
+    CHECK((iterator_values(original.begin_bfs(), original.end_bfs()) == before));
+    CHECK((iterator_values(copy.begin_bfs(), copy.end_bfs()) ==
+           std::vector<std::string>{"root2", "10", "n2", "20.45", "0.5", "n5", "n6", "4.5+7i", "new", "3-1.2i"}));
+
+    // Only the path root -> n2 -> n5 was copied, the rest is still shared
+    CHECK(copy.get_root() != original.get_root());
+    CHECK(copy.get_root()->children[0] == original.get_root()->children[0]);
+    CHECK(copy.get_root()->children[1]->children[1].get() == n6);
+
+    // The original pointer keeps addressing the clone's private copy, which is now full
+    CHECK_THROWS_AS(copy.add_sub_node(n5, std::make_shared<Node<int>>(7)), std::runtime_error);
+    CHECK(n5->children.size() == 1);
+
+    // The original is copy-on-write as well
+    original.add_sub_node(n6, std::make_shared<Node<int>>(9));
+    CHECK(copy.get_root()->children[1]->children[1]->children.size() == 1);
+    CHECK(original.get_root()->children[1]->children[1]->children.size() == 2);
+
+    // Value lookups follow each tree's own nodes
+    CHECK(copy.find_by_value("9").empty());
+    CHECK(original.find_by_value("9").size() == 1);
+    CHECK(original.find_by_value("new").empty());
+
+    // A node of neither tree is rejected instead of modified
+    Node<int> stranger(0);
+    CHECK_THROWS_AS(copy.add_sub_node(&stranger, std::make_shared<Node<int>>(1)), std::runtime_error);
+    CHECK(stranger.children.empty());
+
+    // A rejected add copies nothing
+    Tree full = copy.clone();
+    CHECK_THROWS_AS(full.add_sub_node(n5, std::make_shared<Node<int>>(7)), std::runtime_error);
+    CHECK(full.get_root() == copy.get_root());
+
+    // The value index is shared by the clone until one of the trees writes
+    BaseNode* added = copy.find_by_value("new").front();
+    full.add_sub_node(added, std::make_shared<Node<int>>(11));
+    CHECK(full.find_by_value("11").size() == 1);
+    CHECK(copy.find_by_value("11").empty());
+    CHECK(full.find_by_value("new").front() != added);
+    CHECK(copy.find_by_value("new").front() == added);
+}
+
+// Test that handles keep reaching this tree's nodes across repeated clones
+TEST_CASE("Tree repeated clone tests") {
+    Tree tree(3);
+    auto root = std::make_shared<Node<int>>(1);
+    tree.add_root(root);
+    tree.add_sub_node(root.get(), std::make_shared<Node<int>>(2));
+
+    // Clone, mutate, clone, mutate: the handle to the first root must follow every copy
+    Tree first = tree.clone();
+    tree.add_sub_node(root.get(), std::make_shared<Node<int>>(3));
+    Tree second = tree.clone();
+    tree.add_sub_node(root.get(), std::make_shared<Node<int>>(4));
+    CHECK((iterator_values(first.begin_bfs(), first.end_bfs()) == std::vector<std::string>{"1", "2"}));
+    CHECK((iterator_values(second.begin_bfs(), second.end_bfs()) == std::vector<std::string>{"1", "2", "3"}));
+    CHECK((iterator_values(tree.begin_bfs(), tree.end_bfs()) == std::vector<std::string>{"1", "2", "3", "4"}));
+
+    // The clones resolve the same handle to their own copies
+    second.add_sub_node(root.get(), std::make_shared<Node<int>>(5));
+    first.add_sub_node(root.get(), std::make_shared<Node<int>>(6));
+    CHECK((iterator_values(second.begin_bfs(), second.end_bfs()) == std::vector<std::string>{"1", "2", "3", "5"}));
+    CHECK((iterator_values(first.begin_bfs(), first.end_bfs()) == std::vector<std::string>{"1", "2", "6"}));
+    CHECK((iterator_values(tree.begin_bfs(), tree.end_bfs()) == std::vector<std::string>{"1", "2", "3", "4"}));
+    CHECK(root->children.size() == 1);
+
+    // Value lookups return each tree's own copies, not the nodes they replaced
+    CHECK(tree.find_by_value("1").front() == tree.get_root());
+    CHECK(first.find_by_value("1").front() == first.get_root());
+    CHECK(tree.find_by_value("1").front() != root.get());
+
+    // Writes below an attached subtree, and after a move, still find their path
+    auto branch = std::make_shared<Node<int>>(7);
+    auto leaf = std::make_shared<Node<int>>(8);
+    branch->add_child(leaf);
+    BaseNode* two = root->children[0].get();
+    second.add_sub_node(two, branch);
+    Tree third = second.clone();
+    second.add_sub_node(leaf.get(), std::make_shared<Node<int>>(9));
+    second.move_subtree(leaf.get(), two);
+    Tree fourth = second.clone();
+    second.add_sub_node(leaf.get(), std::make_shared<Node<int>>(10));
+    CHECK((iterator_values(second.begin_pre_order(), second.end_pre_order()) == std::vector<std::string>{"1", "2", "7", "8", "9", "10", "3", "5"}));
+    CHECK((iterator_values(third.begin_bfs(), third.end_bfs()) == std::vector<std::string>{"1", "2", "3", "5", "7", "8"}));
+    CHECK((iterator_values(fourth.begin_pre_order(), fourth.end_pre_order()) == std::vector<std::string>{"1", "2", "7", "8", "9", "3", "5"}));
+    CHECK(leaf->children.empty());
+}
+
+// Test that published versions are frozen and private ones are updated in place
+TEST_CASE("Concurrent tree publication tests") {
+    ConcurrentTree tree(2);
+    CHECK(tree.snapshot().get_root() == nullptr);
+
+    size_t root = tree.add_root(std::make_shared<Node<int>>(0));
+    size_t a = tree.add_sub_node(root, std::make_shared<Node<int>>(1));
+    BaseNode* privateRoot = tree.node(root);
+    tree.add_sub_node(a, std::make_shared<Node<int>>(3));
+    CHECK(tree.node(root) == privateRoot);  // Nothing published yet, so no copies
+    CHECK(tree.snapshot().get_root() == nullptr);
+
+    tree.publish();
+    Tree first = tree.snapshot();
+    CHECK((iterator_values(first.begin_bfs(), first.end_bfs()) == std::vector<std::string>{"0", "1", "3"}));
+
+    // Appending under a published node copies the path and leaves the snapshot intact
+    tree.add_sub_node(a, std::make_shared<Node<int>>(4));
+    tree.add_sub_node(root, std::make_shared<Node<int>>(2));
+    CHECK(tree.node(root) != privateRoot);
+    CHECK((iterator_values(first.begin_bfs(), first.end_bfs()) == std::vector<std::string>{"0", "1", "3"}));
+    CHECK(tree.snapshot().get_root() == first.get_root());
+
+    tree.publish();
+    Tree second = tree.snapshot();
+    CHECK((iterator_values(second.begin_bfs(), second.end_bfs()) == std::vector<std::string>{"0", "1", "2", "3", "4"}));
+    CHECK_THROWS_AS(tree.add_sub_node(a, std::make_shared<Node<int>>(5)), std::runtime_error);
+}
+
+// Test readers traversing while a writer appends
+TEST_CASE("Concurrent tree reader/writer tests") {
+    const int total = 2000;
+    ConcurrentTree tree(2);
+    tree.add_root(std::make_shared<Node<int>>(0));
+    tree.publish();
+
+    // The writer builds a complete binary tree where node i is the parent of 2i+1 and 2i+2
+    std::atomic<bool> writing{true};
+    std::thread writer([&tree, &writing]() {
+        for (int i = 1; i < total; ++i) {
+            tree.add_sub_node(static_cast<size_t>((i - 1) / 2), std::make_shared<Node<int>>(i));
+            if (i % 16 == 0) tree.publish();
+        }
+        tree.publish();
+        writing = false;
+    });
+
+    // Every snapshot must be a consistent prefix of that tree
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&tree, &writing, &consistent]() {
+            size_t last = 0;
+            while (writing) {
+                Tree snapshot = tree.snapshot();
+                size_t count = 0;
+                for (auto node : snapshot) {
+                    int value = static_cast<Node<int>*>(node)->value;
+                    for (size_t c = 0; c < node->children.size(); ++c) {
+                        if (static_cast<Node<int>*>(node->children[c].get())->value != 2 * value + 1 + static_cast<int>(c)) {
+                            consistent = false;
+                        }
+                    }
+                    count++;
+                }
+                if (count < last) consistent = false;
+                last = count;
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& reader : readers) reader.join();
+    CHECK(consistent);
+    Tree final = tree.snapshot();
+    size_t count = 0;
+    for (auto it = final.begin_bfs(); it != final.end_bfs(); ++it) count++;
+    CHECK(count == total);
+}
+
+// Test that explicit positions give the same tree whatever the thread interleaving
+TEST_CASE("Concurrent builder positional tests") {
+    const unsigned int degree = 4;
+    const int threads = 4;
+    const int perThread = 50;
+    std::vector<std::string> expected;
+
+    for (int round = 0; round < 3; ++round) {
+        ConcurrentBuilder builder(degree, 1 + degree + threads * perThread);
+        size_t root = builder.add_root(std::make_shared<Node<std::string>>("root"));
+
+        // Each thread fills the subtree under its own child of the root, in heap order
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&builder, root, t]() {
+                std::vector<size_t> handles;
+                handles.push_back(builder.add_sub_node_at(root, static_cast<unsigned int>(threads - 1 - t), std::make_shared<Node<int>>(t)));
+                for (int i = 1; i < perThread; ++i) {
+                    size_t parent = handles[static_cast<size_t>((i - 1) / 2)];
+                    unsigned int position = static_cast<unsigned int>((i - 1) % 2);
+                    handles.push_back(builder.add_sub_node_at(parent, position, std::make_shared<Node<int>>(t * 1000 + i)));
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        Tree tree = builder.build();
+        std::vector<std::string> values = iterator_values(tree.begin_bfs(), tree.end_bfs());
+        CHECK(values.size() == static_cast<size_t>(1 + threads * perThread));
+        CHECK(values[1] == "3");  // Position decides the order, not which thread came first
+        if (round == 0) {
+            expected = values;
+        }
+        CHECK((values == expected));
+    }
+}
+
+// Test that slot reservation enforces maxDegree under contention
+TEST_CASE("Concurrent builder reservation tests") {
+    const unsigned int degree = 16;
+    ConcurrentBuilder builder(degree, 100);
+    size_t root = builder.add_root(std::make_shared<Node<int>>(0));
+    builder.add_sub_node_at(root, 3, std::make_shared<Node<int>>(-1));
+
+    std::atomic<int> added{0};
+    std::atomic<int> rejected{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < 8; ++i) {
+                try {
+                    builder.add_sub_node(root, std::make_shared<Node<int>>(i));
+                    added++;
+                }
+                catch (const std::runtime_error&) {
+                    rejected++;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    CHECK(added == 15);
+    CHECK(rejected == 17);
+    CHECK_THROWS_AS(builder.add_sub_node_at(root, 3, std::make_shared<Node<int>>(1)), std::runtime_error);
+    CHECK_THROWS_AS(builder.add_sub_node_at(root, degree, std::make_shared<Node<int>>(1)), std::runtime_error);
+
+    Tree tree = builder.build();
+    CHECK(tree.get_root()->children.size() == degree);
+    CHECK(tree.get_root()->children[3]->get_value() == "-1");
+}
+
+// Test that failed additions leave nothing behind and that build() enforces maxDegree
+TEST_CASE("Concurrent builder failure tests") {
+    // Capacities are checked before the slot table is allocated
+    CHECK_THROWS_AS(ConcurrentBuilder(4, std::numeric_limits<uint32_t>::max()), std::runtime_error);
+
+    // Rejected children use up no capacity: the last slot is still free afterwards
+    ConcurrentBuilder builder(2, 4);
+    size_t root = builder.add_root(std::make_shared<Node<int>>(0));
+    size_t first = builder.add_sub_node(root, std::make_shared<Node<int>>(1));
+    builder.add_sub_node_at(root, 1, std::make_shared<Node<int>>(2));
+    CHECK_THROWS_AS(builder.add_sub_node(root, std::make_shared<Node<int>>(3)), std::runtime_error);
+    CHECK_THROWS_AS(builder.add_sub_node_at(root, 0, std::make_shared<Node<int>>(3)), std::runtime_error);
+    size_t last = builder.add_sub_node(first, std::make_shared<Node<int>>(3));
+    CHECK(last == 3);
+
+    // A full builder frees the slot it claimed, and handles past the capacity are unknown
+    CHECK_THROWS_AS(builder.add_sub_node(first, std::make_shared<Node<int>>(4)), std::runtime_error);
+    CHECK_THROWS_AS(builder.add_sub_node(4, std::make_shared<Node<int>>(4)), std::runtime_error);
+    Tree tree = builder.build();
+    CHECK((iterator_values(tree.begin_bfs(), tree.end_bfs()) == std::vector<std::string>{"0", "1", "2", "3"}));
+
+    // Children a node already had count toward maxDegree
+    auto crowded = std::make_shared<Node<int>>(0);
+    crowded->add_child(std::make_shared<Node<int>>(9));
+    ConcurrentBuilder full(2, 3);
+    size_t top = full.add_root(crowded);
+    full.add_sub_node(top, std::make_shared<Node<int>>(1));
+    full.add_sub_node(top, std::make_shared<Node<int>>(2));
+    CHECK_THROWS_AS(full.build(), std::runtime_error);
+    CHECK(crowded->children.size() == 1);
+}
+
+// Helper function to create n integer nodes with values 0 .. n-1
+std::vector<std::shared_ptr<BaseNode>> make_int_nodes(int n) {
+    std::vector<std::shared_ptr<BaseNode>> nodes;
+    for (int i = 0; i < n; ++i) {
+        nodes.push_back(std::make_shared<Node<int>>(i));
+    }
+    return nodes;
+}
+
+// Test bulk construction from parent arrays and edge lists
+TEST_CASE("Tree bulk construction tests") {
+    // Root is node 2; children keep index order
+    Tree tree = Tree::from_parent_array(3, {2, 2, -1, 0, 2, 0}, make_int_nodes(6));
+    CHECK((iterator_values(tree.begin_bfs(), tree.end_bfs()) == std::vector<std::string>{"2", "0", "1", "4", "3", "5"}));
+    CHECK(tree.get_root()->children.capacity() == 3);
+    CHECK(tree.get_root()->children[0]->children.capacity() == 2);
+
+    // Edge lists keep the order of the edges
+    Tree fromEdges = Tree::from_edges(2, 0, {{0, 2}, {0, 1}, {2, 3}}, make_int_nodes(4));
+    CHECK((iterator_values(fromEdges.begin_pre_order(), fromEdges.end_pre_order()) == std::vector<std::string>{"0", "2", "3", "1"}));
+
+    // Invalid inputs
+    CHECK_THROWS_AS(Tree::from_parent_array(2, {-1, 0, 0, 0}, make_int_nodes(4)), std::runtime_error);  // maxDegree
+    CHECK_THROWS_AS(Tree::from_parent_array(2, {-1, -1}, make_int_nodes(2)), std::runtime_error);       // two roots
+    CHECK_THROWS_AS(Tree::from_parent_array(2, {-1, 2, 1}, make_int_nodes(3)), std::runtime_error);     // cycle
+    CHECK_THROWS_AS(Tree::from_parent_array(2, {-1, 5}, make_int_nodes(2)), std::runtime_error);        // range
+    CHECK_THROWS_AS(Tree::from_edges(2, 0, {{0, 1}, {2, 1}}, make_int_nodes(3)), std::runtime_error);   // two parents
+    CHECK(Tree::from_parent_array(2, {}, {}).get_root() == nullptr);
+
+    // The same node at two indices would link a cycle through the pointers
+    auto nodes = make_int_nodes(2);
+    CHECK_THROWS_AS(Tree::from_parent_array(2, {-1, 0, 1}, {nodes[0], nodes[1], nodes[0]}), std::runtime_error);
+    CHECK(nodes[0]->children.empty());
+
+    // Children a node already has count toward maxDegree
+    nodes[0]->add_child(std::make_shared<Node<int>>(7));
+    CHECK_THROWS_AS(Tree::from_parent_array(1, {-1, 0}, nodes), std::runtime_error);
+    CHECK(nodes[0]->children.size() == 1);
+}
+
+// Test removing, detaching and moving subtrees
+TEST_CASE("Tree subtree removal tests") {
+    // 0 -> (1 -> (3, 4), 2 -> (5))
+    auto nodes = make_int_nodes(6);
+    Tree tree = Tree::from_parent_array(2, {-1, 0, 0, 1, 1, 2}, nodes);
+    CHECK(tree.find_by_value("4").size() == 1);
+
+    // Removed nodes stay alive until reclaim
+    std::weak_ptr<BaseNode> removed = nodes[4];
+    tree.remove_subtree(nodes[4].get());
+    nodes.clear();
+    CHECK((iterator_values(tree.begin_pre_order(), tree.end_pre_order()) == std::vector<std::string>{"0", "1", "3", "2", "5"}));
+    CHECK(tree.find_by_value("4").empty());
+    CHECK(tree.pending_reclaim() == 1);
+    CHECK(!removed.expired());
+    tree.reclaim();
+    CHECK(removed.expired());
+    CHECK(tree.pending_reclaim() == 0);
+
+    // Detaching hands the subtree to a new tree
+    BaseNode* one = tree.get_root()->children[0].get();
+    Tree detached = tree.detach_subtree(one);
+    CHECK(detached.get_root() == one);
+    CHECK(detached.get_max_degree() == 2);
+    CHECK((iterator_values(detached.begin_bfs(), detached.end_bfs()) == std::vector<std::string>{"1", "3"}));
+    CHECK((iterator_values(tree.begin_bfs(), tree.end_bfs()) == std::vector<std::string>{"0", "2", "5"}));
+    CHECK_THROWS_AS(tree.remove_subtree(one), std::runtime_error);
+    CHECK_THROWS_AS(tree.remove_subtree(nullptr), std::runtime_error);
+}
+
+// Test moving subtrees, including under copy-on-write
+TEST_CASE("Tree move subtree tests") {
+    auto nodes = make_int_nodes(6);
+    Tree tree = Tree::from_parent_array(2, {-1, 0, 0, 1, 1, 2}, nodes);
+    CHECK(tree.depth_of(nodes[4].get()) == 2);
+
+    tree.move_subtree(nodes[1].get(), nodes[2].get());
+    CHECK((iterator_values(tree.begin_pre_order(), tree.end_pre_order()) == std::vector<std::string>{"0", "2", "5", "1", "3", "4"}));
+    CHECK(tree.depth_of(nodes[4].get()) == 3);
+    CHECK(tree.find_by_value("3").size() == 1);
+
+    // Moving within the same parent only reorders it
+    tree.move_subtree(nodes[5].get(), nodes[2].get());
+    CHECK((iterator_values(tree.begin_pre_order(), tree.end_pre_order()) == std::vector<std::string>{"0", "2", "1", "3", "4", "5"}));
+
+    CHECK_THROWS_AS(tree.move_subtree(nodes[2].get(), nodes[4].get()), std::runtime_error);  // Under itself
+    CHECK_THROWS_AS(tree.move_subtree(nodes[0].get(), nodes[2].get()), std::runtime_error);  // Root
+    CHECK_THROWS_AS(tree.move_subtree(nodes[3].get(), nodes[2].get()), std::runtime_error);  // maxDegree
+
+    // A clone does not see the move, and the original nodes can still be used as handles
+    Tree copy = tree.clone();
+    copy.move_subtree(nodes[4].get(), nodes[5].get());
+    CHECK((iterator_values(copy.begin_pre_order(), copy.end_pre_order()) == std::vector<std::string>{"0", "2", "1", "3", "5", "4"}));
+    CHECK((iterator_values(tree.begin_pre_order(), tree.end_pre_order()) == std::vector<std::string>{"0", "2", "1", "3", "4", "5"}));
+    copy.remove_subtree(nodes[1].get());
+    CHECK((iterator_values(copy.begin_pre_order(), copy.end_pre_order()) == std::vector<std::string>{"0", "2", "5", "4"}));
+    CHECK(tree.get_root()->children[0]->children.size() == 2);
+}
+
+// Test that destroying very deep trees does not recurse
+TEST_CASE("Tree iterative destruction tests") {
+    const long depth = 1000000;
+    std::vector<long> parents;
+    for (long i = 0; i < depth; ++i) {
+        parents.push_back(i - 1);
+    }
+
+    std::weak_ptr<BaseNode> leaf;
+    {
+        Tree path = Tree::from_parent_array(1, parents, make_int_nodes(static_cast<int>(depth)));
+        BaseNode* node = path.get_root();
+        while (!node->children.empty()) {
+            leaf = node->children[0];
+            node = node->children[0].get();
+        }
+    }
+    CHECK(leaf.expired());
+
+    // Nodes still owned by another tree survive the destruction
+    Tree shared = create_another_sample_tree();
+    {
+        Tree copy(shared);
+    }
+    CHECK(shared.get_root()->children.size() == 2);
+
+    // Background reclamation releases the nodes on the reclaimer thread
+    {
+        Tree background = Tree::from_parent_array(1, parents, make_int_nodes(static_cast<int>(depth)));
+        background.set_background_reclaim(true);
+        leaf = background.get_root()->children[0];
+        background.remove_subtree(leaf.lock().get());
+        background.reclaim();
+        Reclaimer::instance().drain();
+        CHECK(leaf.expired());
+    }
+    Reclaimer::instance().drain();
+
+    // A reclaimer of its own releases whatever is still queued when it is destroyed
+    {
+        std::shared_ptr<BaseNode> top = std::make_shared<Node<long>>(0);
+        BaseNode* node = top.get();
+        for (long i = 1; i < depth; ++i) {
+            auto next = std::make_shared<Node<long>>(i);
+            node->add_child(next);
+            node = next.get();
+        }
+        leaf = top->children[0];
+        std::vector<std::shared_ptr<BaseNode>> batch = {std::move(top)};
+        Reclaimer own;
+        own.submit(batch);
+        CHECK(batch.empty());
+    }
+    CHECK(leaf.expired());
+}
+
+// Test the allocation counters
+TEST_CASE("Allocation counting tests") {
+    reset_alloc_stats();
+
+    // One make_shared is one allocation, and freeing it leaves the peak in place
+    {
+        AllocScope scope;
+        {
+            auto node = std::make_shared<Node<int>>(1);
+            CHECK(scope.stats().allocations == 1);
+            CHECK(scope.stats().bytes >= sizeof(Node<int>));
+        }
+        AllocStats stats = scope.stats();
+        CHECK(stats.deallocations == 1);
+        CHECK(stats.peakBytes == stats.bytes);
+    }
+
+    // Nested scopes only see their own allocations
+    {
+        AllocScope outer;
+        std::vector<int> first(100);
+        {
+            AllocScope inner;
+            std::vector<int> second(10);
+            CHECK(inner.stats().allocations == 1);
+            CHECK(inner.stats().peakBytes == 10 * sizeof(int));
+        }
+        CHECK(outer.stats().allocations == 2);
+        CHECK(outer.stats().peakBytes == 110 * sizeof(int));
+    }
+
+    // Allocations of other threads are not counted
+    {
+        AllocScope scope;
+        std::thread other([] { std::vector<int> elsewhere(1000); });
+        size_t afterStart = scope.stats().allocations;
+        other.join();
+        CHECK(scope.stats().bytes < 1000 * sizeof(int));
+        CHECK(scope.stats().allocations == afterStart);
+    }
+
+    // Named scopes accumulate per operation
+    Tree tree = create_another_sample_tree();
+    for (int i = 0; i < 2; ++i) {
+        AllocScope scope("myHeap");
+        Tree heap = tree.myHeap();
+    }
+    for (int i = 0; i < 3; ++i) {
+        AllocScope scope("pre_order");
+        for (auto it = tree.begin_pre_order(); it != tree.end_pre_order(); ++it) {}
+    }
+    AllocStats heap = alloc_stats("myHeap");
+    CHECK(heap.calls == 2);
+    CHECK(heap.allocations >= 2 * 6);  // At least one clone per node
+    CHECK(heap.allocations == heap.deallocations);  // Nothing outlives the scope
+    CHECK(alloc_stats("pre_order").calls == 3);
+    CHECK(alloc_report().size() == 2);
+    CHECK(alloc_stats("unknown").calls == 0);
+    reset_alloc_stats();
+    CHECK(alloc_report().empty());
+}
+
+// Test the memory accounting of a tree
+TEST_CASE("Tree memory stats tests") {
+    // The accounted size of a node matches what make_shared allocates
+    Node<std::string>("probe").control_block_bytes();  // Measure the overhead outside the scope
+    {
+        AllocScope scope;
+        auto node = std::make_shared<Node<std::string>>("short");
+        CHECK(scope.stats().bytes == node->node_bytes() + node->control_block_bytes());
+        CHECK(node->value_heap_bytes() == 0);
+    }
+
+    // Also for a node aligned wider than the control block's counters
+    Node<long double>(0.5L).control_block_bytes();
+    {
+        AllocScope scope;
+        auto node = std::make_shared<Node<long double>>(0.5L);
+        CHECK(scope.stats().bytes == node->node_bytes() + node->control_block_bytes());
+    }
+
+    // Child arrays sized exactly by the bulk builder have no slack
+    Tree exact = Tree::from_parent_array(3, {-1, 0, 0, 0, 1}, make_int_nodes(5));
+    MemoryStats stats = exact.memory_stats();
+    CHECK(stats.nodes == 5);
+    CHECK(stats.nodeBytes == 5 * sizeof(Node<int>));
+    CHECK(stats.childArrayUsedBytes == 4 * sizeof(std::shared_ptr<BaseNode>));
+    CHECK(stats.childArrayBytes == stats.childArrayUsedBytes);
+    CHECK(stats.valueBytes == 0);
+    CHECK(stats.controlBlockBytes == 5 * exact.get_root()->control_block_bytes());
+    CHECK(stats.total() == stats.nodeBytes + stats.controlBlockBytes + stats.childArrayBytes);
+
+    // Long strings are stored outside the node
+    std::string text(100, 'x');
+    Tree strings(2);
+    strings.add_root(std::make_shared<Node<std::string>>(text));
+    strings.add_sub_node(strings.get_root(), std::make_shared<Node<std::string>>("a"));
+    MemoryStats stringStats = strings.memory_stats();
+    CHECK(stringStats.valueBytes == strings.get_root()->value_heap_bytes());
+    CHECK(stringStats.valueBytes > text.size());
+    CHECK(stringStats.childArrayBytes >= stringStats.childArrayUsedBytes);
+
+    CHECK(Tree().memory_stats().total() == 0);
+}
+
+// Test the hardware counter scope, which must work with or without counters
+TEST_CASE("Performance counter tests") {
+    Tree tree = create_complex_tree();
+    PerfScope perf;
+    size_t visited = 0;
+    for (auto it = tree.begin_bfs(); it != tree.end_bfs(); ++it) {
+        visited++;
+    }
+    PerfCounts counts = perf.read();
+    CHECK(visited > 0);
+    CHECK(counts.valid == perf.available());
+    if (counts.valid) {
+        CHECK(counts.instructions > 0);
+        CHECK(counts.cycles > 0);
+    }
+    else {
+        CHECK(counts.instructions == 0);
+        CHECK(counts.cacheMisses == 0);
+    }
+}
+
+// Helper function to count the occurrences of a string
+size_t count_occurrences(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+// Test recording spans and flushing them as Chrome trace events
+TEST_CASE("Tracing tests") {
+    std::ostringstream discard;
+    flush_trace(discard);  // Drop the spans of earlier tests when tracing is compiled in
+
+    {
+        TraceSpan outer("outer");
+        TraceSpan inner("inner \"quoted\"");
+    }
+    std::thread([] { TraceSpan other("other thread"); }).join();
+
+    std::ostringstream out;
+    CHECK(flush_trace(out) >= 3);
+    std::string json = out.str();
+    CHECK(json.rfind("{\"traceEvents\":[", 0) == 0);
+    CHECK(count_occurrences(json, "\"name\":\"outer\",\"ph\":\"X\"") == 1);
+    CHECK(count_occurrences(json, "\"name\":\"inner \\\"quoted\\\"\"") == 1);
+    CHECK(count_occurrences(json, "\"name\":\"other thread\"") == 1);
+
+    // Spans are flushed once
+    std::ostringstream again;
+    CHECK(flush_trace(again) == 0);
+    CHECK(again.str() == "{\"traceEvents\":[\n]}\n");
+
+    // A full ring keeps the most recent spans, all but the slot due to be overwritten next
+    for (size_t i = 0; i < TRACE_BUFFER_SIZE + 10; ++i) {
+        TraceSpan span("spin");
+    }
+    CHECK(flush_trace(discard) == TRACE_BUFFER_SIZE - 1);
+
+#ifdef TREE_TRACING
+    // A traversal span lasts from begin_* until the iterator reaches the end
+    Tree tree = create_complex_tree();
+    flush_trace(discard);
+    size_t visited = 0;
+    for (auto it = tree.begin_bfs(); it != tree.end_bfs(); ++it) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++visited;
+    }
+    std::ostringstream traversal;
+    flush_trace(traversal);
+    std::string events = traversal.str();
+    CHECK(count_occurrences(events, "\"name\":\"Tree::bfs\"") == 1);
+    size_t duration = events.find("\"dur\":", events.find("\"name\":\"Tree::bfs\""));
+    CHECK(std::stod(events.substr(duration + 6)) >= 1000.0 * static_cast<double>(visited));
+
+    // An abandoned traversal ends when its iterator is destroyed
+    {
+        auto it = tree.begin_dfs();
+        ++it;
+    }
+    std::ostringstream abandoned;
+    flush_trace(abandoned);
+    CHECK(count_occurrences(abandoned.str(), "\"name\":\"Tree::dfs\"") == 1);
+#endif
+}
+
+// Test the d-ary node heap
+TEST_CASE("Node heap tests") {
+    // Built from a tree: arity from maxDegree, ordered by ASCII sum like myHeap
+    Tree tree = create_complex_tree();
+    NodeHeap<> heap(tree);
+    std::vector<unsigned int> keys;
+    while (!heap.empty()) {
+        keys.push_back(heap.top()->get_ascii_value());
+        heap.pop_min();
+    }
+    CHECK(keys.size() == tree.euler_index().size());
+    CHECK(std::is_sorted(keys.begin(), keys.end()));
+
+    // Numeric keys, and equal keys leave in push order
+    auto nodes = make_int_nodes(8);
+    NodeHeap<int> numbers(4, NumericKey<int>());
+    for (int i : {5, 3, 7, 0, 6, 1, 4, 2}) {
+        numbers.push(nodes[static_cast<size_t>(i)].get());
+    }
+    auto tie = std::make_shared<Node<int>>(3);
+    numbers.push(tie.get());
+    CHECK(numbers.size() == 9);
+    CHECK(numbers.top() == nodes[0].get());
+
+    // A live scheduler: lower a key and it moves to the front
+    numbers.decrease_key(nodes[6].get(), -1);
+    CHECK(numbers.key_of(nodes[6].get()) == -1);
+    CHECK(numbers.pop_min() == nodes[6].get());
+    std::vector<std::string> order;
+    while (!numbers.empty()) {
+        order.push_back(numbers.pop_min()->get_value());
+    }
+    CHECK((order == std::vector<std::string>{"0", "1", "2", "3", "3", "4", "5", "7"}));
+
+    // Errors
+    NodeHeap<int> custom(3, [](const BaseNode* node) { return -static_cast<int>(node->get_ascii_value()); });
+    custom.push(nodes[1].get());
+    CHECK(custom.key_of(nodes[1].get()) == -49);
+    CHECK_THROWS_AS(custom.push(nodes[1].get()), std::runtime_error);
+    CHECK_THROWS_WITH_AS(custom.push(nullptr), "Error: Cannot push a null node!", std::runtime_error);
+    CHECK_THROWS_WITH_AS(custom.push(nullptr, 0), "Error: Cannot push a null node!", std::runtime_error);
+    CHECK_THROWS_AS(custom.decrease_key(nodes[1].get(), 0), std::runtime_error);
+    CHECK_THROWS_AS(custom.decrease_key(nodes[2].get(), -100), std::runtime_error);
+    CHECK_THROWS_AS(NodeHeap<int>(1), std::runtime_error);
+    CHECK_THROWS_AS(NodeHeap<>().top(), std::runtime_error);
+    CHECK_THROWS_AS(numbers.push(std::make_shared<Node<double>>(1.5).get()), std::runtime_error);
+}
+
+// Helper function to build a complete tree in pointer form: node i's parent is (i-1)/k
+Tree make_complete_tree(unsigned int degree, int n) {
+    std::vector<long> parents;
+    for (long i = 0; i < n; ++i) {
+        parents.push_back(i == 0 ? -1 : (i - 1) / degree);
+    }
+    return Tree::from_parent_array(degree, parents, make_int_nodes(n));
+}
+
+// Test the implicit array-backed complete tree
+TEST_CASE("Complete tree tests") {
+    // Every traversal visits the nodes in the same order as the pointer-based tree
+    for (auto shape : {std::make_pair(1u, 5), std::make_pair(2u, 10), std::make_pair(2u, 15), std::make_pair(3u, 11)}) {
+        Tree tree = make_complete_tree(shape.first, shape.second);
+        CompleteTree complete = CompleteTree::from_tree(tree);
+        CHECK(complete.size() == static_cast<size_t>(shape.second));
+        CHECK(complete.get_root() == tree.get_root());
+        CHECK((iterator_values(complete.begin_bfs(), complete.end_bfs()) == iterator_values(tree.begin_bfs(), tree.end_bfs())));
+        CHECK((iterator_values(complete.begin_dfs(), complete.end_dfs()) == iterator_values(tree.begin_dfs(), tree.end_dfs())));
+        CHECK((iterator_values(complete.begin_pre_order(), complete.end_pre_order()) == iterator_values(tree.begin_pre_order(), tree.end_pre_order())));
+        CHECK((iterator_values(complete.begin_post_order(), complete.end_post_order()) == iterator_values(tree.begin_post_order(), tree.end_post_order())));
+        CHECK((iterator_values(complete.begin_in_order(), complete.end_in_order()) == iterator_values(tree.begin_in_order(), tree.end_in_order())));
+        CHECK((iterator_values(complete.begin(), complete.end()) == iterator_values(tree.begin(), tree.end())));
+
+        // And back again
+        Tree copy = complete.to_tree();
+        CHECK(copy.get_max_degree() == shape.first);
+        CHECK(copy.get_root() != tree.get_root());
+        CHECK((iterator_values(copy.begin_post_order(), copy.end_post_order()) == iterator_values(tree.begin_post_order(), tree.end_post_order())));
+    }
+
+    // Index arithmetic
+    CompleteTree ternary(3, make_int_nodes(11));
+    CHECK(ternary.parent(7) == 2);
+    CHECK(ternary.first_child(2) == 7);
+    CHECK(ternary.child_count(2) == 3);
+    CHECK(ternary.child_count(3) == 1);
+    CHECK(ternary.child_count(4) == 0);
+    CHECK(ternary.node_at(7)->get_value() == "7");
+
+    // The heap shares the nodes and orders them like myHeap
+    Tree tree = create_complex_tree();
+    CompleteTree heap = CompleteTree::min_heap(tree);
+    CHECK(heap.size() == tree.euler_index().size());
+    for (size_t i = 1; i < heap.size(); ++i) {
+        CHECK(heap.node_at(heap.parent(i))->get_ascii_value() <= heap.node_at(i)->get_ascii_value());
+    }
+    Tree pointerHeap = tree.myHeap();
+    CHECK((iterator_values(heap.begin_bfs(), heap.end_bfs()) == iterator_values(pointerHeap.begin_bfs(), pointerHeap.end_bfs())));
+
+    // Errors
+    Tree gap = Tree::from_parent_array(2, {-1, 0, 0, 1, 2}, make_int_nodes(5));
+    CHECK_THROWS_AS(CompleteTree::from_tree(gap), std::runtime_error);
+    CHECK_THROWS_AS(CompleteTree(0, make_int_nodes(2)), std::runtime_error);
+    CHECK_THROWS_AS(CompleteTree(2, {nullptr}), std::runtime_error);
+    CHECK_THROWS_AS(ternary.node_at(11), std::runtime_error);
+    CHECK(CompleteTree::from_tree(Tree(2)).size() == 0);
+}
+
+// Test the parallel key extraction and stable key sort behind myHeap
+TEST_CASE("Parallel key sort tests") {
+    // Enough keys for several threads, with many ties
+    std::vector<unsigned int> keys;
+    std::mt19937 random(3);
+    for (size_t i = 0; i < 5 * PARALLEL_SORT_GRAIN + 17; ++i) {
+        keys.push_back(std::uniform_int_distribution<unsigned int>(0, 999)(random));
+    }
+    std::vector<size_t> expected(keys.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+    for (unsigned int threads : {1u, 2u, 3u, 4u, 0u}) {
+        CHECK(sort_by_key(keys, threads) == expected);
+    }
+    CHECK(sort_by_key({}, 4).empty());
+
+    // Keys match get_ascii_value whatever the number of threads
+    std::vector<std::shared_ptr<BaseNode>> nodes;
+    for (size_t i = 0; i < 3 * PARALLEL_SORT_GRAIN; ++i) {
+        nodes.push_back(std::make_shared<Node<int>>(static_cast<int>(i)));
+    }
+    std::vector<unsigned int> serial = ascii_keys(nodes, 1);
+    CHECK(serial[123] == nodes[123]->get_ascii_value());
+    CHECK(ascii_keys(nodes, 3) == serial);
+
+    // Equal keys keep BFS order, so the heap does not depend on the threads
+    Tree tree = make_complete_tree(3, 40);
+    CompleteTree single = CompleteTree::min_heap(tree, 1);
+    CompleteTree many = CompleteTree::min_heap(tree, 4);
+    std::vector<std::string> order = iterator_values(single.begin(), single.end());
+    CHECK((order == iterator_values(many.begin(), many.end())));
+    CHECK((std::vector<std::string>(order.begin() + 10, order.begin() + 16) == std::vector<std::string>{"10", "11", "20", "12", "21", "30"}));
+}
+
+// Test the counting and radix paths of the key sort
+TEST_CASE("Radix key sort tests") {
+    // Helper to compare a sort against std::stable_sort for every number of threads
+    auto check_sort = [](const std::vector<unsigned int>& keys) {
+        std::vector<size_t> expected(keys.size());
+        std::iota(expected.begin(), expected.end(), 0);
+        std::stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+        for (unsigned int threads : {1u, 3u, 4u}) {
+            CHECK(sort_by_key(keys, threads) == expected);
+        }
+    };
+
+    // Narrow ranges take one counting pass, even far from zero
+    std::vector<unsigned int> ascii = {4000000000u, 4000000100u, 4000000000u, 4000000050u};
+    CHECK(key_sort_method(ascii) == KeySortMethod::Counting);
+    check_sort(ascii);
+
+    // Many keys over a wide range take radix passes; ties are kept in index order
+    std::mt19937 random(5);
+    std::vector<unsigned int> wide;
+    for (size_t i = 0; i < 3 * PARALLEL_SORT_GRAIN; ++i) {
+        wide.push_back(random() % 4 == 0 ? 77u : static_cast<unsigned int>(random()));
+    }
+    CHECK(key_sort_method(wide) == KeySortMethod::Radix);
+    check_sort(wide);
+
+    // Counting stops where the histograms, one per thread, would outgrow the keys
+    std::vector<unsigned int> boundary(2 * PARALLEL_SORT_GRAIN);
+    for (size_t i = 0; i < boundary.size(); ++i) {
+        boundary[i] = static_cast<unsigned int>(i % PARALLEL_SORT_GRAIN);
+    }
+    boundary[0] = static_cast<unsigned int>(PARALLEL_SORT_GRAIN - 1);  // Range of exactly n / 2
+    CHECK(key_sort_method(boundary, 1) == KeySortMethod::Counting);
+    CHECK(key_sort_method(boundary, 2) == KeySortMethod::Counting);
+    check_sort(boundary);
+    boundary[0] = static_cast<unsigned int>(PARALLEL_SORT_GRAIN);  // One bucket more
+    CHECK(key_sort_method(boundary, 1) == KeySortMethod::Counting);
+    CHECK(key_sort_method(boundary, 2) == KeySortMethod::Radix);
+    check_sort(boundary);
+
+    // However many keys there are, a histogram stays within the cache-sized cap
+    std::vector<unsigned int> capped(COUNTING_SORT_MAX_BUCKETS + 1, 0);
+    capped.back() = static_cast<unsigned int>(COUNTING_SORT_MAX_BUCKETS - 1);
+    CHECK(key_sort_method(capped, 1) == KeySortMethod::Counting);
+    capped.back() = static_cast<unsigned int>(COUNTING_SORT_MAX_BUCKETS);
+    CHECK(key_sort_method(capped, 1) == KeySortMethod::Radix);
+
+    // Few keys over a wide range are comparison sorted
+    std::vector<unsigned int> few(wide.begin(), wide.begin() + 100);
+    CHECK(key_sort_method(few) == KeySortMethod::Comparison);
+    check_sort(few);
+
+    // ASCII sums of a large tree's values span a small range
+    Tree tree = make_complete_tree(4, 5000);
+    std::vector<std::shared_ptr<BaseNode>> nodes;
+    for (int i = 0; i < 5000; ++i) {
+        nodes.push_back(std::make_shared<Node<int>>(i));
+    }
+    CHECK(key_sort_method(ascii_keys(nodes)) == KeySortMethod::Counting);
+    Tree heap = tree.myHeap();
+    std::vector<std::string> order = iterator_values(heap.begin_bfs(), heap.end_bfs());
+    CHECK(order.front() == "0");
+    CHECK(order.back() == "4999");
+}
@@ -0,0 +1,166 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "alloc_stats.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+// Per-thread counters, constant-initialized so operator new can use them at any time
+struct ThreadCounters {
+    size_t allocations;
+    size_t deallocations;
+    size_t bytes;
+    int64_t liveBytes;
+    int64_t peakBytes;
+    bool recording;  // Set while the report is updated, so its own allocations are not counted
+};
+
+static thread_local ThreadCounters counters = {0, 0, 0, 0, 0, false};
+
+// Header in front of every block, padded so the block keeps the default alignment
+static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+// Marks blocks in the header that were allocated while counting was suspended
+static constexpr size_t UNCOUNTED = size_t(1) << (sizeof(size_t) * 8 - 1);
+
+// Guards the report, which any thread may update
+static std::mutex& report_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Accumulated counts by operation name
+static std::map<std::string, AllocStats>& report() {
+    static std::map<std::string, AllocStats> operations;
+    return operations;
+}
+
+// Allocates a block with its size in front, and counts it
+void* operator new(size_t size) {
+    void* block = std::malloc(size + HEADER_SIZE);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    if (counters.recording) {
+        *static_cast<size_t*>(block) = size | UNCOUNTED;
+    }
+    else {
+        *static_cast<size_t*>(block) = size;
+        counters.allocations++;
+        counters.bytes += size;
+        counters.liveBytes += static_cast<int64_t>(size);
+        counters.peakBytes = std::max(counters.peakBytes, counters.liveBytes);
+    }
+    return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+// Frees a block allocated above, reading its size from the header. Kept out of line so the
+// compiler never sees free() applied to the result of operator new at a call site
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+void operator delete(void* memory) noexcept {
+    if (!memory) return;
+    void* block = static_cast<char*>(memory) - HEADER_SIZE;
+    size_t size = *static_cast<size_t*>(block);
+    if (!(size & UNCOUNTED)) {
+        counters.deallocations++;
+        counters.liveBytes -= static_cast<int64_t>(size);
+    }
+    std::free(block);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    ::operator delete(memory);
+}
+
+void* operator new[](size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete[](void* memory) noexcept {
+    ::operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    ::operator delete(memory);
+}
+
+// Remembers the thread's counters and starts a fresh peak
+AllocScope::AllocScope(const char* operation)
+    : operation(operation), allocations(counters.allocations), deallocations(counters.deallocations),
+      bytes(counters.bytes), liveBytes(counters.liveBytes), outerPeak(counters.peakBytes) {
+    counters.peakBytes = counters.liveBytes;
+}
+
+// Records the counts, then gives the enclosing scope its peak back
+AllocScope::~AllocScope() {
+    if (operation) {
+        AllocStats current = stats();
+        counters.recording = true;
+        {
+            std::lock_guard<std::mutex> lock(report_mutex());
+            AllocStats& total = report()[operation];
+            total.calls++;
+            total.allocations += current.allocations;
+            total.deallocations += current.deallocations;
+            total.bytes += current.bytes;
+            total.peakBytes = std::max(total.peakBytes, current.peakBytes);
+        }
+        counters.recording = false;
+    }
+    counters.peakBytes = std::max(outerPeak, counters.peakBytes);
+}
+
+// Differences of the thread's counters since the start
+AllocStats AllocScope::stats() const {
+    AllocStats current;
+    current.calls = 1;
+    current.allocations = counters.allocations - allocations;
+    current.deallocations = counters.deallocations - deallocations;
+    current.bytes = counters.bytes - bytes;
+    current.peakBytes = static_cast<size_t>(std::max<int64_t>(0, counters.peakBytes - liveBytes));
+    return current;
+}
+
+// Looks up one operation
+AllocStats alloc_stats(const std::string& operation) {
+    counters.recording = true;
+    AllocStats result;
+    {
+        std::lock_guard<std::mutex> lock(report_mutex());
+        auto it = report().find(operation);
+        if (it != report().end()) {
+            result = it->second;
+        }
+    }
+    counters.recording = false;
+    return result;
+}
+
+// Copies the whole report
+std::map<std::string, AllocStats> alloc_report() {
+    counters.recording = true;
+    std::map<std::string, AllocStats> result;
+    {
+        std::lock_guard<std::mutex> lock(report_mutex());
+        result = report();
+    }
+    counters.recording = false;
+    return result;
+}
+
+// Clears the report
+void reset_alloc_stats() {
+    counters.recording = true;
+    {
+        std::lock_guard<std::mutex> lock(report_mutex());
+        report().clear();
+    }
+    counters.recording = false;
+}
@@ -0,0 +1,84 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * Allocation counting is opt-in: alloc_stats.cpp replaces the global operator new and
+ * operator delete, so only programs that link it (the tests and the benchmarks) pay for it.
+ * Every block carries a small header with its size, and each thread counts its own
+ * allocations, so counting needs no synchronization.
+ */
+
+/**
+ * @brief Allocation counts of one scope, or accumulated over the scopes of one operation.
+ */
+struct AllocStats {
+    size_t calls = 0;          // Number of scopes recorded (1 for a single scope).
+    size_t allocations = 0;    // Number of operator new calls.
+    size_t deallocations = 0;  // Number of operator delete calls.
+    size_t bytes = 0;          // Bytes requested from operator new.
+    size_t peakBytes = 0;      // Highest live memory above the level at the start of the scope.
+};
+
+/**
+ * @brief Counts the allocations the current thread makes while the scope is alive.
+ *
+ * Scopes nest. A named scope adds its counts to the per-operation report when it ends.
+ */
+class AllocScope {
+private:
+    const char* operation;   // Name the counts are recorded under, or null.
+    size_t allocations;      // Thread's allocation count at the start.
+    size_t deallocations;    // Thread's deallocation count at the start.
+    size_t bytes;            // Thread's allocated bytes at the start.
+    int64_t liveBytes;       // Thread's live bytes at the start.
+    int64_t outerPeak;       // Peak of the enclosing scope, restored at the end.
+
+public:
+    /**
+     * @brief Starts counting.
+     * @param operation Name to record the counts under when the scope ends, or null to record nothing.
+     */
+    explicit AllocScope(const char* operation = nullptr);
+
+    /**
+     * @brief Stops counting and records the counts if the scope is named.
+     */
+    ~AllocScope();
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+    /**
+     * @brief Gets the counts since the start of the scope.
+     * @return The counts so far.
+     */
+    AllocStats stats() const;
+};
+
+/**
+ * @brief Gets the counts accumulated by the named scopes of an operation.
+ * @param operation The operation name.
+ * @return The accumulated counts, all zero if the operation was never recorded.
+ */
+AllocStats alloc_stats(const std::string& operation);
+
+/**
+ * @brief Gets the accumulated counts of every recorded operation.
+ * @return The counts by operation name.
+ */
+std::map<std::string, AllocStats> alloc_report();
+
+/**
+ * @brief Forgets every recorded operation.
+ */
+void reset_alloc_stats();
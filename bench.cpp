@@ -0,0 +1,175 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <memory>
+#include <vector>
+#include <random>
+#include <chrono>
+#include "node.hpp"
+#include "tree.hpp"
+#include "Complex.hpp"
+#include "alloc_stats.hpp"
+#include "perf_counters.hpp"
+
+/**
+ * @brief A synthetic tree shape: its maximum degree and the parent of every node.
+ */
+struct Shape {
+    std::string name;             // Name printed in the report.
+    unsigned int degree;          // Maximum degree of the tree.
+    std::vector<size_t> parents;  // Parent index of every node but the root, which is node 0.
+    bool mixed;                   // Whether the values rotate through several types.
+};
+
+/**
+ * @brief Creates the shapes benchmarked for a given number of nodes.
+ * @param count The number of nodes.
+ * @return The shapes.
+ */
+std::vector<Shape> make_shapes(size_t count) {
+    std::vector<Shape> shapes = {
+        {"binary", 2, {}, false},
+        {"4-ary", 4, {}, false},
+        {"8-ary", 8, {}, false},
+        {"path", 1, {}, false},
+        {"star", static_cast<unsigned int>(count), {}, false},
+        {"random", static_cast<unsigned int>(count), {}, false},
+        {"mixed", 2, {}, true},
+    };
+
+    std::mt19937_64 random(42);
+    for (size_t i = 1; i < count; ++i) {
+        shapes[0].parents.push_back((i - 1) / 2);
+        shapes[1].parents.push_back((i - 1) / 4);
+        shapes[2].parents.push_back((i - 1) / 8);
+        shapes[3].parents.push_back(i - 1);
+        shapes[4].parents.push_back(0);
+        shapes[5].parents.push_back(std::uniform_int_distribution<size_t>(0, i - 1)(random));  // Random recursive tree
+        shapes[6].parents.push_back((i - 1) / 2);
+    }
+    return shapes;
+}
+
+/**
+ * @brief Creates the nodes of a shape, with pseudo-random values.
+ * @param shape The shape.
+ * @param count The number of nodes.
+ * @return The nodes.
+ */
+std::vector<std::shared_ptr<BaseNode>> make_nodes(const Shape& shape, size_t count) {
+    std::mt19937 random(7);
+    std::vector<std::shared_ptr<BaseNode>> nodes;
+    nodes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int value = std::uniform_int_distribution<int>(0, 1000000)(random);
+        if (!shape.mixed || i % 4 == 0) {
+            nodes.push_back(std::make_shared<Node<int>>(value));
+        }
+        else if (i % 4 == 1) {
+            nodes.push_back(std::make_shared<Node<double>>(value / 7.0));
+        }
+        else if (i % 4 == 2) {
+            nodes.push_back(std::make_shared<Node<std::string>>("value " + std::to_string(value)));
+        }
+        else {
+            nodes.push_back(std::make_shared<Node<Complex<double, double>>>(Complex<double, double>(value, -value)));
+        }
+    }
+    return nodes;
+}
+
+/**
+ * @brief Runs an operation once and prints its time, allocations, peak live memory and
+ * hardware counters per node.
+ * @param shape The name of the shape.
+ * @param count The number of nodes.
+ * @param operation The name of the operation.
+ * @param run The operation.
+ */
+template <typename Operation>
+void measure(const std::string& shape, size_t count, const std::string& operation, Operation run) {
+    AllocScope scope;
+    PerfScope perf;
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto stop = std::chrono::steady_clock::now();
+    PerfCounts counters = perf.read();
+    AllocStats allocations = scope.stats();
+
+    double nanoseconds = std::chrono::duration<double, std::nano>(stop - start).count();
+    std::cout << std::left << std::setw(8) << shape << std::right << std::setw(11) << count << "  "
+              << std::left << std::setw(14) << operation << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << nanoseconds / static_cast<double>(count)
+              << std::setw(12) << static_cast<double>(allocations.allocations) / static_cast<double>(count)
+              << std::setw(12) << static_cast<double>(allocations.peakBytes) / static_cast<double>(count);
+
+    // Hardware counters, when the machine exposes them
+    if (counters.valid) {
+        double cycles = static_cast<double>(counters.cycles);
+        std::cout << std::setw(8) << (cycles > 0 ? static_cast<double>(counters.instructions) / cycles : 0.0)
+                  << std::setw(12) << static_cast<double>(counters.cacheMisses) / static_cast<double>(count)
+                  << std::setw(12) << static_cast<double>(counters.branchMisses) / static_cast<double>(count);
+    }
+    else {
+        std::cout << std::setw(8) << "-" << std::setw(12) << "-" << std::setw(12) << "-";
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Times one full traversal with a pair of iterators.
+ * @param begin Iterator to the first node.
+ * @param end Iterator past the last node.
+ * @return A checksum, so the traversal cannot be optimized away.
+ */
+template <typename Iterator>
+size_t traverse(Iterator begin, Iterator end) {
+    size_t checksum = 0;
+    for (auto it = begin; it != end; ++it) {
+        checksum += (*it)->children.size();
+    }
+    return checksum;
+}
+
+/**
+ * @brief Benchmarks construction, every traversal and the min-heap for each shape.
+ * @param argc The argument count.
+ * @param argv The arguments; the first is the largest number of nodes (default 100000).
+ * @return The exit status.
+ */
+int main(int argc, char* argv[]) {
+    size_t maxCount = argc > 1 ? std::stoull(argv[1]) : 100000;
+    volatile size_t sink = 0;
+
+    std::cout << "shape         nodes  operation        ns/node allocs/node  peak B/node     IPC LLC mis/node br mis/node" << std::endl;
+    for (size_t count = 1000; count <= maxCount; count *= 10) {
+        for (const Shape& shape : make_shapes(count)) {
+            std::vector<std::shared_ptr<BaseNode>> nodes = make_nodes(shape, count);
+            Tree tree(shape.degree);
+
+            measure(shape.name, count, "add_sub_node", [&] {
+                tree.add_root(nodes[0]);
+                for (size_t i = 1; i < count; ++i) {
+                    tree.add_sub_node(nodes[shape.parents[i - 1]].get(), nodes[i]);
+                }
+            });
+            nodes.clear();
+
+            measure(shape.name, count, "bfs", [&] { sink = sink + traverse(tree.begin_bfs(), tree.end_bfs()); });
+            measure(shape.name, count, "dfs", [&] { sink = sink + traverse(tree.begin_dfs(), tree.end_dfs()); });
+            measure(shape.name, count, "pre_order", [&] { sink = sink + traverse(tree.begin_pre_order(), tree.end_pre_order()); });
+            measure(shape.name, count, "post_order", [&] { sink = sink + traverse(tree.begin_post_order(), tree.end_post_order()); });
+            measure(shape.name, count, "in_order", [&] { sink = sink + traverse(tree.begin_in_order(), tree.end_in_order()); });
+
+            // The heap's arity follows maxDegree, so the shapes compare binary, 4-ary and 8-ary heaps
+            measure(shape.name, count, "myHeap", [&] { sink = sink + (tree.myHeap().get_root() != nullptr); });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,260 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "complete_tree.hpp"
+#include "key_sort.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+// Constructor checks the nodes; any number of nodes forms a complete tree
+CompleteTree::CompleteTree(unsigned int degree, std::vector<std::shared_ptr<BaseNode>> nodes)
+    : maxDegree(degree), nodes(std::move(nodes)) {
+    if (maxDegree == 0 && this->nodes.size() > 1) {
+        throw std::runtime_error("Error: Cannot add child, maxDegree exceeded for parent node!");
+    }
+    for (const auto& node : this->nodes) {
+        if (!node) {
+            throw std::runtime_error("Error: Parent or child node is null!");
+        }
+    }
+}
+
+// Shares the nodes of a tree after checking that it is complete
+CompleteTree CompleteTree::from_tree(const Tree& tree) {
+    TREE_TRACE_SPAN("CompleteTree::from_tree");
+
+    // Collect the owning pointers in BFS order
+    std::vector<std::shared_ptr<BaseNode>> nodes;
+    if (tree.root) nodes.push_back(tree.root);
+    for (size_t head = 0; head < nodes.size(); ++head) {
+        for (const auto& child : nodes[head]->children) {
+            if (!child) {
+                throw std::runtime_error("Error: Encountered null or invalid child node!");
+            }
+            nodes.push_back(child);
+        }
+    }
+
+    // In BFS order, node i of a complete tree has exactly the children k*i+1 .. k*i+k that exist
+    size_t count = nodes.size();
+    size_t arity = tree.maxDegree;
+    for (size_t i = 0; i < count; ++i) {
+        size_t first = arity * i + 1;
+        size_t expected = first >= count ? 0 : std::min(arity, count - first);
+        if (nodes[i]->children.size() != expected) {
+            throw std::runtime_error("Error: Tree is not complete!");
+        }
+    }
+    return CompleteTree(tree.maxDegree, std::move(nodes));
+}
+
+// Orders the nodes of a tree by ASCII sum; a sorted array is a min-heap in implicit layout
+CompleteTree CompleteTree::min_heap(const Tree& tree, unsigned int threads) {
+    TREE_TRACE_SPAN("CompleteTree::min_heap");
+
+    std::vector<std::shared_ptr<BaseNode>> nodes;
+    if (tree.root) nodes.push_back(tree.root);
+    for (size_t head = 0; head < nodes.size(); ++head) {
+        for (const auto& child : nodes[head]->children) {
+            nodes.push_back(child);
+        }
+    }
+
+    // Compute each key once, in parallel, then sort stably by key: equal keys keep BFS order
+    std::vector<size_t> order = sort_by_key(ascii_keys(nodes, threads), threads);
+    std::vector<std::shared_ptr<BaseNode>> sorted;
+    sorted.reserve(nodes.size());
+    for (size_t index : order) {
+        sorted.push_back(std::move(nodes[index]));
+    }
+    return CompleteTree(tree.maxDegree, std::move(sorted));
+}
+
+// Copies the nodes and links them as the children of node i are k*i+1 .. k*i+k
+Tree CompleteTree::to_tree() const {
+    TREE_TRACE_SPAN("CompleteTree::to_tree");
+
+    Tree tree(maxDegree);
+    if (nodes.empty()) return tree;
+
+    std::vector<std::shared_ptr<BaseNode>> copies;
+    copies.reserve(nodes.size());
+    for (const auto& node : nodes) {
+        copies.push_back(node->clone());  // Clones carry no children, so the node's own are left out
+    }
+
+    size_t count = copies.size();
+    for (size_t i = 0; i < count; ++i) {
+        size_t first = first_child(i);
+        if (first >= count) break;
+        size_t last = std::min(first + maxDegree, count);
+
+        std::vector<std::shared_ptr<BaseNode>>& children = copies[i]->children;
+        children.reserve(last - first);
+        for (size_t child = first; child < last; ++child) {
+            children.push_back(copies[child]);
+        }
+    }
+
+    tree.add_root(copies[0]);
+    return tree;
+}
+
+// Function to get the number of nodes
+size_t CompleteTree::size() const {
+    return nodes.size();
+}
+
+// Function to get the arity
+unsigned int CompleteTree::get_max_degree() const {
+    return maxDegree;
+}
+
+// Function to get the root node
+BaseNode* CompleteTree::get_root() const {
+    return nodes.empty() ? nullptr : nodes[0].get();
+}
+
+// Function to get the node at an index
+BaseNode* CompleteTree::node_at(size_t index) const {
+    if (index >= nodes.size()) {
+        throw std::runtime_error("Error: Node index out of range!");
+    }
+    return nodes[index].get();
+}
+
+// Function to get the index of a node's parent
+size_t CompleteTree::parent(size_t index) const {
+    return (index - 1) / maxDegree;
+}
+
+// Function to get the index of a node's first child
+size_t CompleteTree::first_child(size_t index) const {
+    return maxDegree * index + 1;
+}
+
+// Function to get the number of children of a node
+size_t CompleteTree::child_count(size_t index) const {
+    size_t first = first_child(index);
+    return first >= nodes.size() ? 0 : std::min<size_t>(maxDegree, nodes.size() - first);
+}
+
+// Iterator constructor positions on the first node of the order
+CompleteTree::Iterator::Iterator(const CompleteTree* tree, Order order, bool atEnd)
+    : tree(tree), order(order), current(tree->size()) {
+    if (atEnd || tree->size() == 0) return;
+
+    // Post-order and in-order fall back to DFS above arity 2, like Tree
+    if (tree->maxDegree > 2 && (order == Order::PostOrder || order == Order::InOrder)) {
+        this->order = Order::DFS;
+    }
+    bool startsLeftmost = this->order == Order::PostOrder || this->order == Order::InOrder;
+    current = startsLeftmost ? leftmost(0) : 0;
+}
+
+// Follows first children down to a node without children
+size_t CompleteTree::Iterator::leftmost(size_t index) const {
+    while (tree->first_child(index) < tree->size()) {
+        index = tree->first_child(index);
+    }
+    return index;
+}
+
+// Dereference operator to access the current node
+BaseNode* CompleteTree::Iterator::operator*() const {
+    return tree->nodes[current].get();
+}
+
+// Function to get the index of the current node
+size_t CompleteTree::Iterator::index() const {
+    return current;
+}
+
+// Pre-increment operator moves to the next index of the order, without a stack
+CompleteTree::Iterator& CompleteTree::Iterator::operator++() {
+    size_t count = tree->size();
+    size_t arity = tree->maxDegree;
+    if (current >= count) return *this;
+
+    // A node is the last child of its parent if its next sibling belongs to another parent or does not exist
+    auto lastChild = [&](size_t index) { return (index % arity) == 0 || index + 1 >= count; };
+
+    switch (order) {
+        case Order::BFS:
+            ++current;
+            break;
+
+        case Order::DFS:
+        case Order::PreOrder: {
+            size_t first = tree->first_child(current);
+            if (first < count) {
+                current = first;
+                break;
+            }
+            // Climb while the node has no next sibling, then move to that sibling
+            while (current != 0 && lastChild(current)) {
+                current = tree->parent(current);
+            }
+            current = current == 0 ? count : current + 1;
+            break;
+        }
+
+        case Order::PostOrder:
+            if (current == 0) {
+                current = count;
+            }
+            else if (!lastChild(current)) {
+                current = leftmost(current + 1);
+            }
+            else {
+                current = tree->parent(current);
+            }
+            break;
+
+        case Order::InOrder: {
+            // After a node come its later children with their leftmost chains
+            size_t second = tree->first_child(current) + 1;
+            if (arity == 2 && second < count) {
+                current = leftmost(second);
+                break;
+            }
+            // Climb to the first ancestor reached from its first child
+            while (true) {
+                if (current == 0) {
+                    current = count;
+                    break;
+                }
+                size_t up = tree->parent(current);
+                if (current == tree->first_child(up)) {
+                    current = up;
+                    break;
+                }
+                current = up;
+            }
+            break;
+        }
+    }
+    return *this;
+}
+
+// Inequality operator to compare two iterators
+bool CompleteTree::Iterator::operator!=(const Iterator& other) const {
+    return current != other.current || tree != other.tree;
+}
+
+CompleteTree::Iterator CompleteTree::begin_bfs() const { return Iterator(this, Order::BFS, false); }
+CompleteTree::Iterator CompleteTree::end_bfs() const { return Iterator(this, Order::BFS, true); }
+CompleteTree::Iterator CompleteTree::begin_dfs() const { return Iterator(this, Order::DFS, false); }
+CompleteTree::Iterator CompleteTree::end_dfs() const { return Iterator(this, Order::DFS, true); }
+CompleteTree::Iterator CompleteTree::begin_pre_order() const { return Iterator(this, Order::PreOrder, false); }
+CompleteTree::Iterator CompleteTree::end_pre_order() const { return Iterator(this, Order::PreOrder, true); }
+CompleteTree::Iterator CompleteTree::begin_post_order() const { return Iterator(this, Order::PostOrder, false); }
+CompleteTree::Iterator CompleteTree::end_post_order() const { return Iterator(this, Order::PostOrder, true); }
+CompleteTree::Iterator CompleteTree::begin_in_order() const { return Iterator(this, Order::InOrder, false); }
+CompleteTree::Iterator CompleteTree::end_in_order() const { return Iterator(this, Order::InOrder, true); }
+CompleteTree::Iterator CompleteTree::begin() const { return begin_bfs(); }
+CompleteTree::Iterator CompleteTree::end() const { return end_bfs(); }
@@ -0,0 +1,180 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "tree.hpp"
+#include <vector>
+
+/**
+ * @brief A complete k-ary tree stored as one array, without child pointers.
+ *
+ * Node i's children are at k*i+1 .. k*i+k and its parent at (i-1)/k, so the structure costs
+ * no memory at all. The nodes only provide the values: their own children vectors are not
+ * part of this tree and are ignored. Traversals walk the indices, without a stack or queue.
+ */
+class CompleteTree {
+private:
+    unsigned int maxDegree;                        // The arity k.
+    std::vector<std::shared_ptr<BaseNode>> nodes;  // The nodes in BFS order.
+
+public:
+    /**
+     * @brief Traversal orders, matching the Tree iterators.
+     */
+    enum class Order { BFS, DFS, PreOrder, PostOrder, InOrder };
+
+    /**
+     * @brief Index-based iterator over the nodes in one of the traversal orders.
+     */
+    class Iterator {
+    private:
+        const CompleteTree* tree;  // The tree being traversed.
+        Order order;               // The traversal order.
+        size_t current;            // Index of the current node, size() at the end.
+
+        /**
+         * @brief Gets the last node reached by repeatedly taking the first child.
+         */
+        size_t leftmost(size_t index) const;
+
+    public:
+        /**
+         * @brief Constructor positions the iterator on the first node of the order.
+         * @param tree The tree.
+         * @param order The traversal order.
+         * @param atEnd True for the end iterator.
+         */
+        Iterator(const CompleteTree* tree, Order order, bool atEnd);
+
+        /**
+         * @brief Dereference operator to access the current node.
+         * @return Pointer to the current node.
+         */
+        BaseNode* operator*() const;
+
+        /**
+         * @brief Gets the array index of the current node.
+         * @return The index.
+         */
+        size_t index() const;
+
+        /**
+         * @brief Pre-increment operator to move to the next node.
+         * @return Reference to the updated iterator.
+         */
+        Iterator& operator++();
+
+        /**
+         * @brief Inequality operator to compare two iterators.
+         * @param other The other iterator to compare.
+         * @return True if the iterators are not equal, false otherwise.
+         */
+        bool operator!=(const Iterator& other) const;
+    };
+
+    /**
+     * @brief Constructor arranges nodes, given in BFS order, as a complete tree.
+     * @param degree The arity k.
+     * @param nodes The nodes in BFS order.
+     * @throw std::runtime_error if a node is null, or the degree is 0 with more than one node.
+     */
+    CompleteTree(unsigned int degree, std::vector<std::shared_ptr<BaseNode>> nodes);
+
+    /**
+     * @brief Takes the nodes of a complete tree, sharing them rather than copying.
+     * @param tree A tree whose levels are all full except the last, filled from the left.
+     * @return The complete tree, with the tree's maxDegree as arity.
+     * @throw std::runtime_error if the tree is not complete.
+     */
+    static CompleteTree from_tree(const Tree& tree);
+
+    /**
+     * @brief Arranges the nodes of a tree as a k-ary min-heap, ordered by ASCII sum.
+     *
+     * The nodes are shared, not copied, so the heap costs one array of pointers. Keys are
+     * computed and sorted across threads; nodes with equal keys keep their BFS order, so the
+     * heap is the same for any number of threads.
+     *
+     * @param tree The tree; its maxDegree is the arity.
+     * @param threads The number of threads to use, or 0 for one per hardware thread.
+     * @return The heap.
+     */
+    static CompleteTree min_heap(const Tree& tree, unsigned int threads = 0);
+
+    /**
+     * @brief Converts into a pointer-based Tree with copies of the nodes.
+     * @return The tree.
+     */
+    Tree to_tree() const;
+
+    /**
+     * @brief Gets the number of nodes.
+     * @return The number of nodes.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the arity of the tree.
+     * @return The arity k.
+     */
+    unsigned int get_max_degree() const;
+
+    /**
+     * @brief Gets the root node.
+     * @return The root, or null if the tree is empty.
+     */
+    BaseNode* get_root() const;
+
+    /**
+     * @brief Gets the node at an index.
+     * @param index The index, below size().
+     * @return The node.
+     */
+    BaseNode* node_at(size_t index) const;
+
+    /**
+     * @brief Gets the index of a node's parent.
+     * @param index The index of a node other than the root.
+     * @return The index of the parent.
+     */
+    size_t parent(size_t index) const;
+
+    /**
+     * @brief Gets the index of a node's first child.
+     * @param index The index of the node.
+     * @return The index of the first child, size() or more if there is none.
+     */
+    size_t first_child(size_t index) const;
+
+    /**
+     * @brief Gets the number of children of a node.
+     * @param index The index of the node.
+     * @return The number of children.
+     */
+    size_t child_count(size_t index) const;
+
+    Iterator begin_bfs() const;
+    Iterator end_bfs() const;
+    Iterator begin_dfs() const;
+    Iterator end_dfs() const;
+    Iterator begin_pre_order() const;
+    Iterator end_pre_order() const;
+
+    /**
+     * @brief Post-order and in-order traversals fall back to DFS when the arity is above 2, like Tree.
+     */
+    Iterator begin_post_order() const;
+    Iterator end_post_order() const;
+    Iterator begin_in_order() const;
+    Iterator end_in_order() const;
+
+    /**
+     * @brief Range-based for loops traverse in BFS order, like Tree.
+     */
+    Iterator begin() const;
+    Iterator end() const;
+};
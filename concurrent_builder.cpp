@@ -0,0 +1,146 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "concurrent_builder.hpp"
+#include <limits>
+#include <stdexcept>
+
+// Helper function to validate the capacity before anything is allocated for it
+static size_t checked_capacity(unsigned int degree, size_t capacity) {
+    if (capacity >= std::numeric_limits<uint32_t>::max() ||
+        (degree != 0 && capacity > std::numeric_limits<size_t>::max() / degree)) {
+        throw std::runtime_error("Error: Builder capacity is too large!");
+    }
+    return capacity;
+}
+
+// Constructor allocates the node table and every slot block at once
+ConcurrentBuilder::ConcurrentBuilder(unsigned int degree, size_t capacity)
+    : maxDegree(degree), capacity(checked_capacity(degree, capacity)), nodes(capacity),
+      slots(new std::atomic<uint32_t>[capacity * degree]),
+      reserved(new std::atomic<uint32_t>[capacity]), count(0) {
+    for (size_t i = 0; i < capacity * degree; ++i) {
+        slots[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+        reserved[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+// Claims the next handle; the node table is preallocated so distinct handles never race
+uint32_t ConcurrentBuilder::register_node(std::shared_ptr<BaseNode> node) {
+    if (!node) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+    size_t handle = count.fetch_add(1, std::memory_order_relaxed);
+    if (handle >= capacity) {
+        count.fetch_sub(1, std::memory_order_relaxed);
+        throw std::runtime_error("Error: Builder capacity exceeded!");
+    }
+    nodes[handle] = std::move(node);
+    return static_cast<uint32_t>(handle);
+}
+
+// The count runs past the capacity for a moment while a registration fails, so check both
+void ConcurrentBuilder::check_handle(size_t handle) const {
+    if (handle >= capacity || handle >= count.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Error: Unknown node handle!");
+    }
+}
+
+size_t ConcurrentBuilder::add_root(std::shared_ptr<BaseNode> root_node) {
+    if (count.load(std::memory_order_relaxed) != 0) {
+        throw std::runtime_error("Error: Root already set!");
+    }
+    return register_node(std::move(root_node));
+}
+
+// Claims a free slot, then registers the child into it; a failed registration frees the slot again.
+// Registration only fails once the capacity is used up, and it never frees up again, so the
+// reservation counter of add_sub_node is not moved back: no later addition could use the slot.
+uint32_t ConcurrentBuilder::fill_slot(std::atomic<uint32_t>& slot, std::shared_ptr<BaseNode> child) {
+    uint32_t handle = 0;
+    try {
+        handle = register_node(std::move(child));
+    }
+    catch (...) {
+        slot.store(0, std::memory_order_relaxed);
+        throw;
+    }
+    slot.store(handle + 1, std::memory_order_release);
+    return handle;
+}
+
+// Reserves slots in order with an atomic counter, skipping the ones taken by explicit positions
+size_t ConcurrentBuilder::add_sub_node(size_t parent, std::shared_ptr<BaseNode> child) {
+    check_handle(parent);
+    if (!child) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+    std::atomic<uint32_t>* block = &slots[parent * maxDegree];
+    for (;;) {
+        uint32_t slot = reserved[parent].fetch_add(1, std::memory_order_relaxed);
+        if (slot >= maxDegree) {
+            throw std::runtime_error("Error: Cannot add child, maxDegree exceeded for parent node!");
+        }
+        uint32_t empty = 0;
+        if (block[slot].compare_exchange_strong(empty, CLAIMED_SLOT, std::memory_order_relaxed)) {
+            return fill_slot(block[slot], std::move(child));
+        }
+    }
+}
+
+// Claims one exact slot; fails if another thread got there first
+size_t ConcurrentBuilder::add_sub_node_at(size_t parent, unsigned int position, std::shared_ptr<BaseNode> child) {
+    check_handle(parent);
+    if (!child) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+    if (position >= maxDegree) {
+        throw std::runtime_error("Error: Cannot add child, maxDegree exceeded for parent node!");
+    }
+
+    std::atomic<uint32_t>& slot = slots[parent * maxDegree + position];
+    uint32_t empty = 0;
+    if (!slot.compare_exchange_strong(empty, CLAIMED_SLOT, std::memory_order_relaxed)) {
+        throw std::runtime_error("Error: Child position already taken!");
+    }
+    return fill_slot(slot, std::move(child));
+}
+
+// Links the slots into children vectors sized exactly, in position order
+Tree ConcurrentBuilder::build() {
+    Tree tree(maxDegree);
+    size_t total = count.load(std::memory_order_acquire);
+    if (total == 0) return tree;
+
+    // Children the nodes already had count toward maxDegree; check every node before linking any
+    std::vector<size_t> used(total, 0);
+    for (size_t parent = 0; parent < total; ++parent) {
+        std::atomic<uint32_t>* block = &slots[parent * maxDegree];
+        for (unsigned int i = 0; i < maxDegree; ++i) {
+            if (block[i].load(std::memory_order_acquire) != 0) used[parent]++;
+        }
+        if (used[parent] != 0 && nodes[parent]->children.size() + used[parent] > maxDegree) {
+            throw std::runtime_error("Error: Cannot add child, maxDegree exceeded for parent node!");
+        }
+    }
+
+    for (size_t parent = 0; parent < total; ++parent) {
+        if (used[parent] == 0) continue;
+        std::atomic<uint32_t>* block = &slots[parent * maxDegree];
+        std::vector<std::shared_ptr<BaseNode>>& children = nodes[parent]->children;
+        children.reserve(children.size() + used[parent]);
+        for (unsigned int i = 0; i < maxDegree; ++i) {
+            uint32_t value = block[i].load(std::memory_order_relaxed);
+            if (value != 0) {
+                children.push_back(nodes[value - 1]);
+            }
+        }
+    }
+    tree.add_root(nodes[0]);
+    return tree;
+}
@@ -0,0 +1,106 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "tree.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class ConcurrentBuilder
+ * @brief Builds a tree from many threads at once, without locks.
+ *
+ * Every node gets a fixed block of maxDegree child slots. Threads attach children by
+ * reserving a slot with an atomic counter, or by claiming an explicit position with a
+ * compare-and-swap, so the maxDegree limit holds without ever reading children.size().
+ * Nodes are addressed by the handles the builder returns. Once every thread is done,
+ * build() links the nodes into a Tree, children ordered by slot.
+ *
+ * When every child is attached with an explicit position, the resulting tree is the
+ * same whatever the interleaving of the threads.
+ */
+class ConcurrentBuilder {
+private:
+    unsigned int maxDegree;                             // Maximum number of children each node can have.
+    size_t capacity;                                    // Maximum number of nodes.
+    std::vector<std::shared_ptr<BaseNode>> nodes;       // Node of each handle.
+    std::unique_ptr<std::atomic<uint32_t>[]> slots;     // Child slots, maxDegree per node: handle + 1, 0 when empty, CLAIMED_SLOT while filling.
+    std::unique_ptr<std::atomic<uint32_t>[]> reserved;  // Next slot to try for unpositioned children, per node.
+    std::atomic<size_t> count;                          // Number of handles handed out.
+
+    static constexpr uint32_t CLAIMED_SLOT = UINT32_MAX;  // Slot value while its child is being registered.
+
+    /**
+     * @brief Registers a node and returns its handle.
+     */
+    uint32_t register_node(std::shared_ptr<BaseNode> node);
+
+    /**
+     * @brief Registers a child into a slot this thread claimed, or frees the slot if that fails.
+     *
+     * That only fails once the capacity is exhausted, for good, so the reservation counter
+     * that led add_sub_node to the slot is left past it.
+     */
+    uint32_t fill_slot(std::atomic<uint32_t>& slot, std::shared_ptr<BaseNode> child);
+
+    /**
+     * @brief Checks that a handle was handed out, and lies within the capacity.
+     */
+    void check_handle(size_t handle) const;
+
+public:
+    /**
+     * @brief Constructor to allocate room for all the nodes up front.
+     * @param degree Maximum number of children each node can have.
+     * @param capacity Maximum number of nodes, root included.
+     * @throw std::runtime_error if the capacity is too large, checked before allocating.
+     */
+    ConcurrentBuilder(unsigned int degree, size_t capacity);
+
+    /**
+     * @brief Sets the root. Must be called once, before any child is added.
+     * @param root_node The root node.
+     * @return The handle of the root.
+     * @throw std::runtime_error if the root is null or the capacity is exhausted.
+     */
+    size_t add_root(std::shared_ptr<BaseNode> root_node);
+
+    /**
+     * @brief Attaches a child in the next free slot of a parent. Safe to call from any thread.
+     * @param parent The handle of the parent.
+     * @param child The node to add.
+     * @return The handle of the child.
+     * @throw std::runtime_error if the child is null, the parent is full or the capacity is exhausted.
+     * A failed call leaves no node registered and no slot taken.
+     */
+    size_t add_sub_node(size_t parent, std::shared_ptr<BaseNode> child);
+
+    /**
+     * @brief Attaches a child at an explicit position of a parent. Safe to call from any thread.
+     * @param parent The handle of the parent.
+     * @param position The position of the child, below maxDegree.
+     * @param child The node to add.
+     * @return The handle of the child.
+     * @throw std::runtime_error if the child is null, the position is out of range or taken,
+     * or the capacity is exhausted.
+     */
+    size_t add_sub_node_at(size_t parent, unsigned int position, std::shared_ptr<BaseNode> child);
+
+    /**
+     * @brief Links all the nodes into a tree. Call once all the adding threads are joined.
+     *
+     * Children are ordered by position; empty positions are skipped. Children a node already
+     * had come first and count toward maxDegree.
+     *
+     * @return The built tree.
+     * @throw std::runtime_error if a node would end up with more than maxDegree children;
+     * nothing is linked then.
+     */
+    Tree build();
+};
@@ -0,0 +1,87 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "concurrent_tree.hpp"
+#include <atomic>
+#include <stdexcept>
+
+// Constructor starts with nothing published
+ConcurrentTree::ConcurrentTree(unsigned int degree) : maxDegree(degree), epoch(0) {}
+
+// Starts a new writer version; it is visible to readers after the next publish
+size_t ConcurrentTree::add_root(std::shared_ptr<BaseNode> root_node) {
+    if (!root_node) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+    working = root_node;
+    current.assign(1, root_node.get());
+    parents.assign(1, 0);
+    slots.assign(1, 0);
+    born.assign(1, epoch);
+    return 0;
+}
+
+// Copies the published part of the path from the root to the handle
+BaseNode* ConcurrentTree::writable(size_t handle) {
+    // Collect the handles up to the first ancestor that is already private to the writer
+    std::vector<size_t> path;
+    for (size_t h = handle; born[h] != epoch; h = parents[h]) {
+        path.push_back(h);
+        if (h == 0) break;
+    }
+
+    // Copy top-down, each copy replacing the published node in its private parent
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        size_t h = *it;
+        std::shared_ptr<BaseNode> copy = current[h]->clone();
+        copy->children = current[h]->children;
+        if (h == 0) {
+            working = copy;
+        }
+        else {
+            current[parents[h]]->children[slots[h]] = copy;
+        }
+        current[h] = copy.get();
+        born[h] = epoch;
+    }
+    return current[handle];
+}
+
+// Appends a child under a private version of the parent
+size_t ConcurrentTree::add_sub_node(size_t parent, std::shared_ptr<BaseNode> child) {
+    if (!child) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+    if (current.at(parent)->children.size() >= maxDegree) {
+        throw std::runtime_error("Error: Cannot add child, maxDegree exceeded for parent node!");
+    }
+
+    BaseNode* node = writable(parent);
+    size_t handle = current.size();
+    current.push_back(child.get());
+    parents.push_back(parent);
+    slots.push_back(node->children.size());
+    born.push_back(epoch);
+    node->add_child(child);
+    return handle;
+}
+
+BaseNode* ConcurrentTree::node(size_t handle) const {
+    return current.at(handle);
+}
+
+// Swaps the shared root; everything reachable from it is frozen from now on
+void ConcurrentTree::publish() {
+    std::atomic_store(&published, working);
+    ++epoch;
+}
+
+// Pins the published version for the lifetime of the returned tree
+Tree ConcurrentTree::snapshot() const {
+    Tree tree(maxDegree);
+    tree.add_root(std::atomic_load(&published));
+    return tree;
+}
@@ -0,0 +1,89 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "tree.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ConcurrentTree
+ * @brief A tree that one writer grows while any number of readers traverse it.
+ *
+ * The writer works on a private version and makes it visible with publish(), which
+ * swaps the shared root atomically. Readers take a snapshot() and traverse it with the
+ * usual Tree iterators, without locks. A published node is never modified again: when
+ * the writer appends under one, it copies the path from the root to it first (read-copy-
+ * update), so an in-flight iterator never sees a children array change under it. Nodes
+ * created or copied since the last publish are modified in place. Old versions are
+ * reclaimed when the last snapshot holding them is destroyed.
+ *
+ * The writer addresses nodes through the handles returned by add_root and add_sub_node,
+ * since copying replaces the node objects.
+ */
+class ConcurrentTree {
+private:
+    std::shared_ptr<BaseNode> published;   // Root visible to readers, accessed atomically.
+    unsigned int maxDegree;                // Maximum number of children each node can have.
+
+    // Writer state
+    std::shared_ptr<BaseNode> working;     // Root of the writer's version.
+    std::vector<BaseNode*> current;        // Current object of each handle.
+    std::vector<size_t> parents;           // Parent handle of each handle.
+    std::vector<size_t> slots;             // Index of each handle in its parent's children.
+    std::vector<uint64_t> born;            // Epoch in which each handle's current object was created.
+    uint64_t epoch;                        // Number of publications so far.
+
+    /**
+     * @brief Gets an object for a handle that readers cannot see, copying the path to it if needed.
+     */
+    BaseNode* writable(size_t handle);
+
+public:
+    /**
+     * @brief Constructor to initialize an empty tree.
+     * @param degree Maximum number of children each node can have.
+     */
+    explicit ConcurrentTree(unsigned int degree = 2);
+
+    /**
+     * @brief Replaces the writer's version with a new root. Writer only.
+     * @param root_node The new root node.
+     * @return The handle of the root.
+     * @throw std::runtime_error if the root is null.
+     */
+    size_t add_root(std::shared_ptr<BaseNode> root_node);
+
+    /**
+     * @brief Appends a child to a node of the writer's version. Writer only.
+     * @param parent The handle of the parent.
+     * @param child The node to add.
+     * @return The handle of the child.
+     * @throw std::runtime_error if the child is null or the parent is full.
+     * @throw std::out_of_range if the handle does not exist.
+     */
+    size_t add_sub_node(size_t parent, std::shared_ptr<BaseNode> child);
+
+    /**
+     * @brief Gets the writer's current object for a handle. Writer only.
+     * @param handle The handle of the node.
+     * @return Pointer to the node in the writer's version.
+     * @throw std::out_of_range if the handle does not exist.
+     */
+    BaseNode* node(size_t handle) const;
+
+    /**
+     * @brief Makes the writer's version visible to readers. Writer only.
+     */
+    void publish();
+
+    /**
+     * @brief Gets the latest published version. Safe to call from any thread.
+     * @return A tree holding the published version alive for as long as it exists.
+     */
+    Tree snapshot() const;
+};
@@ -0,0 +1,99 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "euler_index.hpp"
+#include <stdexcept>
+
+// Builds the index by walking the tree once in pre-order
+EulerIndex::EulerIndex(BaseNode* root) {
+    if (!root) return;
+
+    std::vector<std::pair<BaseNode*, size_t>> stack;  // Nodes to visit with their parent id.
+    stack.push_back({root, npos});
+
+    while (!stack.empty()) {
+        auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        size_t id = nodes.size();
+        nodes.push_back(node);
+        parents.push_back(parent);
+        depths.push_back(parent == npos ? 0 : depths[parent] + 1);
+        ids.emplace(node, id);
+
+        // Add children in reverse order so they are visited left to right
+        auto& children = node->children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            if (*it == nullptr) {
+                throw std::runtime_error("Error: Encountered null or invalid child node!");
+            }
+            stack.push_back({it->get(), id});
+        }
+    }
+
+    // Children always have larger ids than their parent, so one reverse pass sums the sizes
+    sizes.assign(nodes.size(), 1);
+    for (size_t id = nodes.size() - 1; id > 0; --id) {
+        sizes[parents[id]] += sizes[id];
+    }
+}
+
+size_t EulerIndex::size() const {
+    return nodes.size();
+}
+
+bool EulerIndex::contains(const BaseNode* node) const {
+    return ids.find(node) != ids.end();
+}
+
+size_t EulerIndex::id_of(const BaseNode* node) const {
+    auto it = ids.find(node);
+    if (it == ids.end()) {
+        throw std::runtime_error("Error: Node is not part of the tree!");
+    }
+    return it->second;
+}
+
+BaseNode* EulerIndex::node_at(size_t id) const {
+    return nodes[id];
+}
+
+size_t EulerIndex::parent(size_t id) const {
+    return parents[id];
+}
+
+size_t EulerIndex::entry(size_t id) const {
+    return id;
+}
+
+size_t EulerIndex::exit(size_t id) const {
+    return id + sizes[id] - 1;
+}
+
+size_t EulerIndex::subtree_size(size_t id) const {
+    return sizes[id];
+}
+
+size_t EulerIndex::depth(size_t id) const {
+    return depths[id];
+}
+
+// The descendant's entry time must fall inside the ancestor's interval
+bool EulerIndex::is_ancestor(size_t ancestor, size_t descendant) const {
+    return ancestor <= descendant && descendant <= exit(ancestor);
+}
+
+size_t EulerIndex::subtree_size(const BaseNode* node) const {
+    return subtree_size(id_of(node));
+}
+
+size_t EulerIndex::depth(const BaseNode* node) const {
+    return depth(id_of(node));
+}
+
+bool EulerIndex::is_ancestor(const BaseNode* ancestor, const BaseNode* descendant) const {
+    return is_ancestor(id_of(ancestor), id_of(descendant));
+}
@@ -0,0 +1,128 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "node.hpp"
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @class EulerIndex
+ * @brief Interval index over a tree for constant time subtree and ancestor queries.
+ *
+ * Every node gets an id equal to its entry time in a pre-order walk. The nodes of a
+ * subtree then occupy the contiguous id range [entry, exit], so ancestor checks and
+ * subtree sizes are plain array lookups. The index is a snapshot: it must be rebuilt
+ * after the tree changes.
+ */
+class EulerIndex {
+private:
+    std::vector<BaseNode*> nodes;                  // Nodes ordered by entry time.
+    std::vector<size_t> parents;                   // Parent id of each node, by id (the root has none).
+    std::vector<size_t> sizes;                     // Subtree size of each node, by id.
+    std::vector<size_t> depths;                    // Depth of each node, by id (root is 0).
+    std::unordered_map<const BaseNode*, size_t> ids;  // Id of each node.
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);  // Parent id of the root.
+
+    /**
+     * @brief Builds the index in a single pre-order pass.
+     * @param root Pointer to the root node (may be null).
+     * @throw std::runtime_error if a null child is encountered.
+     */
+    explicit EulerIndex(BaseNode* root);
+
+    /**
+     * @brief Gets the number of indexed nodes.
+     * @return The number of nodes in the tree.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether a node is part of the indexed tree.
+     * @param node The node to look up.
+     * @return True if the node is in the tree, false otherwise.
+     */
+    bool contains(const BaseNode* node) const;
+
+    /**
+     * @brief Gets the id (entry time) of a node.
+     * @param node The node to look up.
+     * @return The id of the node.
+     * @throw std::runtime_error if the node is not in the tree.
+     */
+    size_t id_of(const BaseNode* node) const;
+
+    /**
+     * @brief Gets the node with a given id.
+     * @param id The id of the node.
+     * @return Pointer to the node.
+     */
+    BaseNode* node_at(size_t id) const;
+
+    /**
+     * @brief Gets the id of a node's parent.
+     * @param id The id of the node.
+     * @return The id of the parent, or EulerIndex::npos for the root.
+     */
+    size_t parent(size_t id) const;
+
+    /**
+     * @brief Gets the entry time of a node.
+     * @param id The id of the node.
+     * @return The entry time, which is the id itself.
+     */
+    size_t entry(size_t id) const;
+
+    /**
+     * @brief Gets the exit time of a node, the entry time of the last node in its subtree.
+     * @param id The id of the node.
+     * @return The exit time of the node.
+     */
+    size_t exit(size_t id) const;
+
+    /**
+     * @brief Gets the number of nodes in a subtree, the node itself included.
+     * @param id The id of the subtree's root.
+     * @return The size of the subtree.
+     */
+    size_t subtree_size(size_t id) const;
+
+    /**
+     * @brief Gets the depth of a node.
+     * @param id The id of the node.
+     * @return The depth of the node (the root is at depth 0).
+     */
+    size_t depth(size_t id) const;
+
+    /**
+     * @brief Checks whether one node is an ancestor of another. A node is its own ancestor.
+     * @param ancestor The id of the candidate ancestor.
+     * @param descendant The id of the candidate descendant.
+     * @return True if ancestor lies on the path from the root to descendant.
+     */
+    bool is_ancestor(size_t ancestor, size_t descendant) const;
+
+    /**
+     * @brief Node based overload of subtree_size.
+     * @throw std::runtime_error if the node is not in the tree.
+     */
+    size_t subtree_size(const BaseNode* node) const;
+
+    /**
+     * @brief Node based overload of depth.
+     * @throw std::runtime_error if the node is not in the tree.
+     */
+    size_t depth(const BaseNode* node) const;
+
+    /**
+     * @brief Node based overload of is_ancestor.
+     * @throw std::runtime_error if either node is not in the tree.
+     */
+    bool is_ancestor(const BaseNode* ancestor, const BaseNode* descendant) const;
+};
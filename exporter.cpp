@@ -0,0 +1,98 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "exporter.hpp"
+#include "layout.hpp"
+#include <string>
+#include <vector>
+
+// Helper function to escape a label for a quoted DOT string
+static void write_dot_escaped(std::ostream& os, const std::string& text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            os << '\\';
+        }
+        os << c;
+    }
+}
+
+// Helper function to escape text for XML content and attributes
+static void write_xml_escaped(std::ostream& os, const std::string& text) {
+    for (char c : text) {
+        switch (c) {
+            case '&': os << "&amp;"; break;
+            case '<': os << "&lt;"; break;
+            case '>': os << "&gt;"; break;
+            case '"': os << "&quot;"; break;
+            default: os << c;
+        }
+    }
+}
+
+// Writes the tree as a DOT digraph with nodes numbered in pre-order
+void TreeExporter::write_dot(const Tree& tree, std::ostream& os) {
+    os << "digraph Tree {\n";
+    os << "    node [shape=circle, style=filled, fillcolor=black, fontcolor=white];\n";
+
+    // The pre-order iterator pops a node and pushes its children in reverse order,
+    // so a stack of parent ids pushed the same way stays in step with it
+    std::vector<size_t> parents;
+    size_t id = 0;
+    for (auto it = tree.begin_pre_order(); it != tree.end_pre_order(); ++it, ++id) {
+        BaseNode* node = *it;
+
+        os << "    n" << id << " [label=\"";
+        write_dot_escaped(os, node->get_value());
+        os << "\"];\n";
+
+        if (id != 0) {
+            os << "    n" << parents.back() << " -> n" << id << ";\n";
+            parents.pop_back();
+        }
+        parents.insert(parents.end(), node->children.size(), id);
+    }
+
+    os << "}\n";
+}
+
+// Writes the tree as an SVG image using the same layout as the GUI
+void TreeExporter::write_svg(const Tree& tree, std::ostream& os, float width, float height) {
+    os << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height << "\">\n";
+    os << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+
+    // Layouts are pushed in the same order the pre-order iterator pushes the nodes
+    std::vector<NodeLayout> layouts;
+    if (tree.get_root()) {
+        layouts.push_back(root_layout(width));
+    }
+
+    for (auto it = tree.begin_pre_order(); it != tree.end_pre_order(); ++it) {
+        BaseNode* node = *it;
+        NodeLayout layout = layouts.back();
+        layouts.pop_back();
+
+        // Draw the edges first so the node circles are painted over them
+        size_t count = node->children.size();
+        for (size_t i = 0; i < count; ++i) {
+            NodeLayout child = child_layout(layout, i, count);
+            os << "<line x1=\"" << layout.x << "\" y1=\"" << layout.y
+               << "\" x2=\"" << child.x << "\" y2=\"" << child.y - NODE_RADIUS
+               << "\" stroke=\"black\"/>\n";
+        }
+        for (size_t i = count; i > 0; --i) {
+            layouts.push_back(child_layout(layout, i - 1, count));
+        }
+
+        // Draw the node's circle and its value
+        os << "<circle cx=\"" << layout.x << "\" cy=\"" << layout.y << "\" r=\"" << NODE_RADIUS << "\" fill=\"black\"/>\n";
+        os << "<text x=\"" << layout.x << "\" y=\"" << layout.y
+           << "\" fill=\"white\" font-family=\"Arial\" font-size=\"18\" text-anchor=\"middle\" dominant-baseline=\"central\">";
+        write_xml_escaped(os, node->get_value());
+        os << "</text>\n";
+    }
+
+    os << "</svg>\n";
+}
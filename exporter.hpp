@@ -0,0 +1,36 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "tree.hpp"
+#include <ostream>
+
+/**
+ * @class TreeExporter
+ * @brief Streams a tree to text formats without opening a window.
+ *
+ * Both exporters walk the tree once in pre-order and write every node as soon as
+ * it is visited, so the memory used does not depend on the size of the output.
+ */
+class TreeExporter {
+public:
+    /**
+     * @brief Writes the tree as a Graphviz DOT digraph.
+     * @param tree The tree to export.
+     * @param os Output stream to write to.
+     */
+    static void write_dot(const Tree& tree, std::ostream& os);
+
+    /**
+     * @brief Writes the tree as an SVG image, laid out like the GUI window.
+     * @param tree The tree to export.
+     * @param os Output stream to write to.
+     * @param width Width of the canvas.
+     * @param height Height of the canvas.
+     */
+    static void write_svg(const Tree& tree, std::ostream& os, float width = 800, float height = 600);
+};
@@ -0,0 +1,264 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "generator.hpp"
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+// FramePool implementations
+
+FramePool::FramePool(size_t maxBuffers) : maxBuffers(maxBuffers) {}
+
+// Hands out an idle buffer if there is one, otherwise a new empty buffer
+std::vector<TraversalFrame> FramePool::acquire() {
+    if (buffers.empty()) {
+        return {};
+    }
+    std::vector<TraversalFrame> buffer = std::move(buffers.back());
+    buffers.pop_back();
+    return buffer;
+}
+
+// Keeps the buffer's capacity for the next traversal, up to the pool limit
+void FramePool::release(std::vector<TraversalFrame>&& buffer) {
+    if (buffers.size() < maxBuffers) {
+        buffer.clear();
+        buffers.push_back(std::move(buffer));
+    }
+}
+
+size_t FramePool::idle() const {
+    return buffers.size();
+}
+
+// TraversalGenerator implementations
+
+// Constructor allocates its own buffer, which is freed with the generator
+TraversalGenerator::TraversalGenerator(const Tree& tree, Order order)
+    : head(0), order(order), pool(nullptr), remaining(std::numeric_limits<size_t>::max()) {
+    start(tree);
+}
+
+// Constructor borrows a buffer from the pool
+TraversalGenerator::TraversalGenerator(const Tree& tree, Order order, FramePool& pool)
+    : frames(pool.acquire()), head(0), order(order), pool(&pool),
+      remaining(std::numeric_limits<size_t>::max()) {
+    start(tree);
+}
+
+// Suspends the traversal before the root
+void TraversalGenerator::start(const Tree& tree) {
+    // Like the Tree iterators, the ordered traversals switch to DFS when maxDegree > 2
+    if (tree.get_max_degree() > 2 && order != Order::BFS) {
+        this->order = Order::DFS;
+    }
+    if (tree.get_root()) {
+        frames.push_back({tree.get_root(), 0});
+    }
+}
+
+TraversalGenerator::TraversalGenerator(TraversalGenerator&& other) noexcept
+    : frames(std::move(other.frames)), head(other.head), order(other.order), pool(other.pool),
+      filters(std::move(other.filters)), remaining(other.remaining) {
+    other.pool = nullptr;
+}
+
+TraversalGenerator& TraversalGenerator::operator=(TraversalGenerator&& other) noexcept {
+    if (this != &other) {
+        if (pool) {
+            pool->release(std::move(frames));
+        }
+        frames = std::move(other.frames);
+        head = other.head;
+        order = other.order;
+        pool = other.pool;
+        filters = std::move(other.filters);
+        remaining = other.remaining;
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+// Destructor hands the buffer back so the next traversal can reuse it
+TraversalGenerator::~TraversalGenerator() {
+    if (pool) {
+        pool->release(std::move(frames));
+    }
+}
+
+void TraversalGenerator::push(BaseNode* node) {
+    if (node == nullptr) {
+        throw std::runtime_error("Error: Encountered null or invalid child node!");
+    }
+    frames.push_back({node, 0});
+}
+
+// Advances the state machine of the selected order by one produced node
+BaseNode* TraversalGenerator::step() {
+    switch (order) {
+        case Order::BFS: {
+            if (head == frames.size()) return nullptr;
+            BaseNode* node = frames[head++].node;
+            for (auto& child : node->children) {
+                push(child.get());
+            }
+
+            // Reclaim the consumed front of the queue once it dominates the buffer
+            if (head >= 1024 && head * 2 >= frames.size()) {
+                frames.erase(frames.begin(), frames.begin() + static_cast<std::ptrdiff_t>(head));
+                head = 0;
+            }
+            return node;
+        }
+
+        case Order::DFS:
+        case Order::PreOrder: {
+            if (frames.empty()) return nullptr;
+            BaseNode* node = frames.back().node;
+            frames.pop_back();
+            auto& children = node->children;
+            for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                push(it->get());
+            }
+            return node;
+        }
+
+        case Order::PostOrder: {
+            // A node is produced once all of its children have been
+            while (!frames.empty()) {
+                TraversalFrame& top = frames.back();
+                if (top.next < top.node->children.size()) {
+                    BaseNode* child = top.node->children[top.next++].get();
+                    push(child);
+                }
+                else {
+                    BaseNode* node = top.node;
+                    frames.pop_back();
+                    return node;
+                }
+            }
+            return nullptr;
+        }
+
+        case Order::InOrder: {
+            // A node is produced after its first child, then its other children follow
+            while (!frames.empty()) {
+                TraversalFrame& top = frames.back();
+                if (top.next == 0 && !top.node->children.empty()) {
+                    top.next = 1;
+                    push(top.node->children[0].get());
+                }
+                else {
+                    BaseNode* node = top.node;
+                    frames.pop_back();
+                    for (size_t i = 1; i < node->children.size(); ++i) {
+                        push(node->children[i].get());
+                    }
+                    return node;
+                }
+            }
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+// Resumes until a node passes every filter or the traversal ends
+BaseNode* TraversalGenerator::next() {
+    while (remaining > 0) {
+        BaseNode* node = step();
+        if (!node) {
+            remaining = 0;
+            return nullptr;
+        }
+
+        bool accepted = true;
+        for (auto& predicate : filters) {
+            if (!predicate(node)) {
+                accepted = false;
+                break;
+            }
+        }
+        if (accepted) {
+            --remaining;
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+bool TraversalGenerator::done() const {
+    if (remaining == 0) return true;
+    return order == Order::BFS ? head == frames.size() : frames.empty();
+}
+
+TraversalGenerator& TraversalGenerator::filter(std::function<bool(BaseNode*)> predicate) {
+    filters.push_back(std::move(predicate));
+    return *this;
+}
+
+TraversalGenerator& TraversalGenerator::take(size_t count) {
+    remaining = count;
+    return *this;
+}
+
+// Iterator implementations
+
+TraversalGenerator::iterator::iterator(TraversalGenerator* generator)
+    : generator(generator), current(generator ? generator->next() : nullptr) {
+    if (!current) {
+        this->generator = nullptr;
+    }
+}
+
+BaseNode* TraversalGenerator::iterator::operator*() const {
+    return current;
+}
+
+TraversalGenerator::iterator& TraversalGenerator::iterator::operator++() {
+    current = generator->next();
+    if (!current) {
+        generator = nullptr;
+    }
+    return *this;
+}
+
+bool TraversalGenerator::iterator::operator!=(const iterator& other) const {
+    return generator != other.generator;
+}
+
+TraversalGenerator::iterator TraversalGenerator::begin() {
+    return iterator(this);
+}
+
+TraversalGenerator::iterator TraversalGenerator::end() {
+    return iterator(nullptr);
+}
+
+// Gives every unfinished generator a quantum of nodes per round until all are done
+void interleave(std::vector<TraversalGenerator>& generators, size_t quantum,
+                const std::function<void(size_t, BaseNode*)>& visit) {
+    if (quantum == 0) {
+        throw std::runtime_error("Error: Quantum must be at least 1!");  // No generator would ever advance
+    }
+    std::vector<bool> finished(generators.size(), false);
+    size_t active = generators.size();
+    while (active > 0) {
+        for (size_t i = 0; i < generators.size(); ++i) {
+            if (finished[i]) continue;
+            for (size_t step = 0; step < quantum; ++step) {
+                BaseNode* node = generators[i].next();
+                if (!node) {
+                    finished[i] = true;
+                    --active;
+                    break;
+                }
+                visit(i, node);
+            }
+        }
+    }
+}
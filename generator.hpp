@@ -0,0 +1,193 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "tree.hpp"
+#include <functional>
+#include <vector>
+
+/**
+ * @struct TraversalFrame
+ * @brief One suspended step of a traversal: a node and the index of its next child to visit.
+ */
+struct TraversalFrame {
+    BaseNode* node;  // The node of the frame.
+    size_t next;     // Index of the next child to visit.
+};
+
+/**
+ * @class FramePool
+ * @brief Recycles the frame buffers of finished traversals.
+ *
+ * A traversal borrows a buffer when it starts and returns it, capacity intact, when it
+ * is destroyed, so running many short traversals does not allocate once the pool is warm.
+ * A pool must only be used from one thread, and must outlive the generators borrowing from
+ * it: a pooled generator has to be destroyed on the thread that owns its pool.
+ */
+class FramePool {
+private:
+    std::vector<std::vector<TraversalFrame>> buffers;  // Idle buffers.
+    size_t maxBuffers;                                 // Maximum number of idle buffers kept.
+
+public:
+    /**
+     * @brief Constructor to initialize the pool.
+     * @param maxBuffers Maximum number of idle buffers kept for reuse.
+     */
+    explicit FramePool(size_t maxBuffers = 64);
+
+    /**
+     * @brief Borrows an empty buffer, reusing an idle one if possible.
+     * @return An empty buffer.
+     */
+    std::vector<TraversalFrame> acquire();
+
+    /**
+     * @brief Returns a buffer to the pool.
+     * @param buffer The buffer to recycle.
+     */
+    void release(std::vector<TraversalFrame>&& buffer);
+
+    /**
+     * @brief Gets the number of idle buffers.
+     * @return The number of buffers ready for reuse.
+     */
+    size_t idle() const;
+};
+
+/**
+ * @class TraversalGenerator
+ * @brief A traversal that can be suspended after any node and resumed later.
+ *
+ * The whole traversal state lives in a pooled frame buffer, so a generator can be kept
+ * around between calls, interleaved with generators over other trees and combined with
+ * filter and take without collecting nodes into intermediate vectors. It produces the
+ * same sequences as the matching Tree iterators.
+ */
+class TraversalGenerator {
+public:
+    /**
+     * @brief The traversal orders, matching the begin_* iterators of Tree.
+     */
+    enum class Order { BFS, DFS, PreOrder, PostOrder, InOrder };
+
+private:
+    std::vector<TraversalFrame> frames;   // Stack of suspended frames (a queue for BFS).
+    size_t head;                          // Front of the queue for BFS.
+    Order order;                          // Order produced by the generator.
+    FramePool* pool;                      // Pool the frame buffer is returned to, or null if the generator owns it.
+    std::vector<std::function<bool(BaseNode*)>> filters;  // Predicates every produced node must pass.
+    size_t remaining;                     // Number of nodes still allowed by take().
+
+    /**
+     * @brief Produces the next node of the underlying traversal, ignoring filters and limits.
+     */
+    BaseNode* step();
+
+    /**
+     * @brief Pushes a frame for a node, checking it is not null.
+     */
+    void push(BaseNode* node);
+
+    /**
+     * @brief Settles the order for the tree and suspends the traversal before the root.
+     */
+    void start(const Tree& tree);
+
+public:
+    /**
+     * @brief Constructor to start a traversal of a tree with a frame buffer of its own.
+     *
+     * The generator is not tied to any thread and may be moved to and destroyed on another.
+     *
+     * @param tree The tree to traverse. It must outlive the generator and not change while traversed.
+     * @param order The traversal order.
+     */
+    TraversalGenerator(const Tree& tree, Order order);
+
+    /**
+     * @brief Constructor to start a traversal of a tree with a buffer borrowed from a pool.
+     * @param tree The tree to traverse. It must outlive the generator and not change while traversed.
+     * @param order The traversal order.
+     * @param pool The pool to borrow the frame buffer from. The generator must be destroyed
+     * on the thread that uses the pool, before the pool.
+     */
+    TraversalGenerator(const Tree& tree, Order order, FramePool& pool);
+
+    TraversalGenerator(TraversalGenerator&& other) noexcept;
+    TraversalGenerator& operator=(TraversalGenerator&& other) noexcept;
+    TraversalGenerator(const TraversalGenerator&) = delete;
+    TraversalGenerator& operator=(const TraversalGenerator&) = delete;
+
+    /**
+     * @brief Destructor returns the frame buffer to the pool, if it came from one.
+     */
+    ~TraversalGenerator();
+
+    /**
+     * @brief Resumes the traversal until the next node that passes the filters.
+     * @return The next node, or nullptr once the traversal is over.
+     * @throw std::runtime_error if a null child is encountered.
+     */
+    BaseNode* next();
+
+    /**
+     * @brief Checks whether the traversal is over.
+     * @return True if no node is left to produce.
+     */
+    bool done() const;
+
+    /**
+     * @brief Keeps only the nodes matching a predicate. Several filters must all match.
+     * @param predicate The predicate to apply.
+     * @return Reference to this generator.
+     */
+    TraversalGenerator& filter(std::function<bool(BaseNode*)> predicate);
+
+    /**
+     * @brief Stops the traversal after a number of produced nodes.
+     * @param count The maximum number of nodes still to produce.
+     * @return Reference to this generator.
+     */
+    TraversalGenerator& take(size_t count);
+
+    /**
+     * @class iterator
+     * @brief Input iterator so a generator can drive a range-based for loop.
+     */
+    class iterator {
+    private:
+        TraversalGenerator* generator;  // The generator being consumed, null at the end.
+        BaseNode* current;              // The node the iterator points to.
+
+    public:
+        explicit iterator(TraversalGenerator* generator);
+        BaseNode* operator*() const;
+        iterator& operator++();
+        bool operator!=(const iterator& other) const;
+    };
+
+    /**
+     * @brief Gets an iterator resuming the traversal.
+     */
+    iterator begin();
+
+    /**
+     * @brief Gets the end iterator.
+     */
+    iterator end();
+};
+
+/**
+ * @brief Runs several generators cooperatively, a few nodes from each in turn.
+ * @param generators The generators to run.
+ * @param quantum Number of nodes taken from a generator before moving to the next one, at least 1.
+ * @param visit Called with the index of the generator and every node it produces.
+ * @throw std::runtime_error if the quantum is 0.
+ */
+void interleave(std::vector<TraversalGenerator>& generators, size_t quantum,
+                const std::function<void(size_t, BaseNode*)>& visit);
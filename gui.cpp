@@ -5,12 +5,14 @@
  */
 
 #include "gui.hpp"
+#include "trace.hpp"
 
 /**
  * @brief Renders the entire tree in a window.
  * @param tree The tree to render.
  */
 void GUI::renderTree(const Tree& tree) const {
+    TREE_TRACE_SPAN("GUI::renderTree");
 
     // Create a window for visualization
     sf::RenderWindow window(sf::VideoMode(800, 600), "Tree Visualization");
@@ -34,7 +36,7 @@ void GUI::renderTree(const Tree& tree) const {
 
         // Render the root node and its children recursively if the root is not null
         if (tree.get_root()) {
-            renderNode(window, tree.get_root(), window.getSize().x / 2, 50, window.getSize().x, font, 0.001);
+            renderNode(window, tree.get_root(), root_layout(static_cast<float>(window.getSize().x)), font);
         }
 
         // Display the rendered frame on the window
@@ -46,17 +48,17 @@ void GUI::renderTree(const Tree& tree) const {
  * @brief Recursively renders a node and its children.
  * @param window The window to draw on.
  * @param node The current node to render.
- * @param x The x-coordinate of the node.
- * @param y The y-coordinate of the node.
- * @param xOffset The horizontal offset for child nodes.
+ * @param layout The position of the node and the spread left for its children.
  * @param font The font used to draw text.
- * @param depth The current depth in the tree.
  */
-void GUI::renderNode(sf::RenderWindow& window, BaseNode* node, float x, float y, float xOffset, sf::Font& font, double depth) const {
+void GUI::renderNode(sf::RenderWindow& window, BaseNode* node, const NodeLayout& layout, sf::Font& font) const {
     if (!node) return;
 
+    float x = layout.x;
+    float y = layout.y;
+
     // Define the radius for the node's circle
-    float radius = 35.0f;
+    float radius = NODE_RADIUS;
 
     // Create and configure the circle shape representing the node
     sf::CircleShape shape(radius);
@@ -75,28 +77,21 @@ void GUI::renderNode(sf::RenderWindow& window, BaseNode* node, float x, float y,
     text.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
     text.setPosition(x, y);
 
-    // Calculate the position for the children nodes
-    float childY = y + 2 * radius + 60;  // Adjust vertical distance between nodes
-    float adjustedXOffset = xOffset / (depth + 0.9);  // Adjust horizontal spread based on depth
-    if (depth == 1) adjustedXOffset = xOffset;  // Significant spread for the first level
-
-    float startX = x - (adjustedXOffset / 2);
-
     // Iterate over each child node and render them recursively
     for (size_t i = 0; i < node->children.size(); i++) {
         BaseNode* child = node->children[i].get();
-        float childX = startX + (i + 1) * (adjustedXOffset / (node->children.size() + 1));
+        NodeLayout childLayout = child_layout(layout, i, node->children.size());
 
         // Draw connecting lines between the current node and its children
         sf::Vertex line[] = {
                 sf::Vertex(sf::Vector2f(x, y)),
-                sf::Vertex(sf::Vector2f(childX, childY - radius), sf::Color::Black)
+                sf::Vertex(sf::Vector2f(childLayout.x, childLayout.y - radius), sf::Color::Black)
         };
 
         window.draw(line, 2, sf::Lines);
 
         // Recursively render the child nodes
-        renderNode(window, child, childX, childY, xOffset * 0.7, font, depth + 1);  // Further decrease horizontal spread
+        renderNode(window, child, childLayout, font);
     }
 
     // Draw the current node's circle and text
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "tree.hpp"
+#include "layout.hpp"
 #include <SFML/Graphics.hpp>
 
 /**
@@ -26,11 +27,8 @@ private:
      * @brief Recursively renders a node and its children.
      * @param window The window to draw on.
      * @param node The current node to render.
-     * @param x The x-coordinate of the node.
-     * @param y The y-coordinate of the node.
-     * @param xOffset The horizontal offset for child nodes.
+     * @param layout The position of the node and the spread left for its children.
      * @param font The font used to draw text.
-     * @param depth The current depth in the tree.
      */
-    void renderNode(sf::RenderWindow& window, BaseNode* node, float x, float y, float xOffset, sf::Font& font, double depth) const;
+    void renderNode(sf::RenderWindow& window, BaseNode* node, const NodeLayout& layout, sf::Font& font) const;
 };
\ No newline at end of file
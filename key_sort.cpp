@@ -0,0 +1,163 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "key_sort.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <utility>
+
+// Helper function to pick how many threads to use for a number of elements
+static unsigned int thread_count(size_t count, unsigned int requested) {
+    unsigned int threads = requested != 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+    size_t useful = std::max<size_t>(1, count / PARALLEL_SORT_GRAIN);
+    return static_cast<unsigned int>(std::min<size_t>(threads, useful));
+}
+
+// Helper function to run body(chunk, begin, end) over equal chunks of [0, count), one thread per chunk
+template <typename Body>
+static void parallel_chunks(size_t count, unsigned int threads, Body body) {
+    if (threads <= 1) {
+        body(0u, size_t(0), count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    for (unsigned int t = 0; t < threads; ++t) {
+        size_t begin = count * t / threads;
+        size_t end = count * (t + 1) / threads;
+        workers.emplace_back([&, t, begin, end] {
+            try {
+                body(t, begin, end);
+            }
+            catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+// Computes the keys chunk by chunk; each thread writes only its own slots
+std::vector<unsigned int> ascii_keys(const std::vector<std::shared_ptr<BaseNode>>& nodes, unsigned int threads) {
+    TREE_TRACE_SPAN("ascii_keys");
+
+    std::vector<unsigned int> keys(nodes.size());
+    parallel_chunks(nodes.size(), thread_count(nodes.size(), threads), [&](unsigned int, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            keys[i] = nodes[i]->get_ascii_value();
+        }
+    });
+    return keys;
+}
+
+// Sorts (key, index) pairs; they compare by key, then index, so equal keys keep index order
+static std::vector<size_t> comparison_sort(const std::vector<unsigned int>& keys) {
+    size_t count = keys.size();
+    std::vector<std::pair<unsigned int, size_t>> pairs(count);
+    for (size_t i = 0; i < count; ++i) {
+        pairs[i] = {keys[i], i};
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = pairs[i].second;
+    }
+    return order;
+}
+
+// One stable counting pass: orders the indices in from by bucket(keys[index]) into to.
+// Each thread counts its own chunk; bucket b of chunk t starts after bucket b of every earlier chunk.
+template <typename Bucket>
+static void counting_pass(const std::vector<unsigned int>& keys, const std::vector<size_t>& from, std::vector<size_t>& to,
+                          size_t buckets, unsigned int threads, Bucket bucket) {
+    size_t count = from.size();
+    std::vector<std::vector<size_t>> offsets(threads, std::vector<size_t>(buckets, 0));
+    parallel_chunks(count, threads, [&](unsigned int chunk, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ++offsets[chunk][bucket(keys[from[i]])];
+        }
+    });
+
+    size_t position = 0;
+    for (size_t b = 0; b < buckets; ++b) {
+        for (unsigned int chunk = 0; chunk < threads; ++chunk) {
+            size_t size = offsets[chunk][b];
+            offsets[chunk][b] = position;
+            position += size;
+        }
+    }
+
+    parallel_chunks(count, threads, [&](unsigned int chunk, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            to[offsets[chunk][bucket(keys[from[i]])]++] = from[i];
+        }
+    });
+}
+
+// Helper function to choose a method from the number of keys, the distance between the
+// smallest and largest, and the number of threads that would each keep a histogram
+static KeySortMethod method_for(size_t count, unsigned int spread, unsigned int chunks) {
+    size_t buckets = size_t(spread) + 1;
+    if (buckets <= COUNTING_SORT_MAX_BUCKETS && (buckets <= RADIX_BUCKETS || buckets * chunks <= count)) {
+        return KeySortMethod::Counting;
+    }
+    if (count >= RADIX_SORT_MIN) return KeySortMethod::Radix;
+    return KeySortMethod::Comparison;
+}
+
+// Chooses counting sort for narrow key ranges, radix sort for many keys, comparison sort otherwise
+KeySortMethod key_sort_method(const std::vector<unsigned int>& keys, unsigned int threads) {
+    if (keys.empty()) return KeySortMethod::Counting;
+    auto [low, high] = std::minmax_element(keys.begin(), keys.end());
+    return method_for(keys.size(), *high - *low, thread_count(keys.size(), threads));
+}
+
+// Sorts with the method suited to the keys; all of them give the same stable order
+std::vector<size_t> sort_by_key(const std::vector<unsigned int>& keys, unsigned int threads) {
+    TREE_TRACE_SPAN("sort_by_key");
+
+    size_t count = keys.size();
+    if (count == 0) return {};
+
+    // Keys are bucketed relative to the smallest one, so only the bits of the range matter
+    auto [lowest, highest] = std::minmax_element(keys.begin(), keys.end());
+    unsigned int low = *lowest;
+    unsigned int spread = *highest - low;
+    unsigned int chunks = thread_count(count, threads);
+    KeySortMethod method = method_for(count, spread, chunks);
+    if (method == KeySortMethod::Comparison) {
+        return comparison_sort(keys);  // Too few keys to be worth a thread
+    }
+
+    std::vector<size_t> order(count);
+    std::vector<size_t> buffer(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+
+    if (method == KeySortMethod::Counting) {
+        counting_pass(keys, order, buffer, size_t(spread) + 1, chunks, [low](unsigned int key) { return key - low; });
+        return buffer;
+    }
+
+    // LSD radix sort: one stable pass per byte of the range, least significant first
+    for (unsigned int shift = 0; shift < 32 && (spread >> shift) != 0; shift += 8) {
+        counting_pass(keys, order, buffer, RADIX_BUCKETS, chunks, [low, shift](unsigned int key) {
+            return ((key - low) >> shift) & 0xFF;
+        });
+        order.swap(buffer);
+    }
+    return order;
+}
@@ -0,0 +1,78 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "node.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Smallest number of elements given to each thread; below it, work stays on the calling thread.
+ */
+constexpr size_t PARALLEL_SORT_GRAIN = 1 << 15;
+
+/**
+ * @brief Number of buckets of one radix sort pass, one per byte value.
+ */
+constexpr size_t RADIX_BUCKETS = 256;
+
+/**
+ * @brief Smallest number of keys for which radix sort beats comparison sort on a wide key range.
+ */
+constexpr size_t RADIX_SORT_MIN = 1 << 10;
+
+/**
+ * @brief Most buckets a counting pass may use per thread, so its histogram stays in cache.
+ */
+constexpr size_t COUNTING_SORT_MAX_BUCKETS = 1 << 16;
+
+/**
+ * @brief The ways sort_by_key can order keys.
+ */
+enum class KeySortMethod {
+    Counting,    // One counting pass, when every thread's histogram is small next to the keys.
+    Radix,       // LSD radix sort, one byte of the key range per pass.
+    Comparison   // Comparison sort, for fewer than RADIX_SORT_MIN keys spread over a wide range.
+};
+
+/**
+ * @brief Chooses how sort_by_key orders a set of keys.
+ *
+ * Every thread of a counting pass keeps one histogram with a bucket per key in the range,
+ * so counting is chosen only while those histograms stay small.
+ *
+ * @param keys The keys.
+ * @param threads The number of threads sort_by_key is given, or 0 for one per hardware thread.
+ * @return Counting sort when the range between the smallest and largest key needs at most
+ * COUNTING_SORT_MAX_BUCKETS buckets, and either at most RADIX_BUCKETS or few enough that
+ * buckets times threads does not exceed keys.size(). Otherwise radix sort for at least
+ * RADIX_SORT_MIN keys, and comparison sort below that.
+ */
+KeySortMethod key_sort_method(const std::vector<unsigned int>& keys, unsigned int threads = 0);
+
+/**
+ * @brief Computes the ASCII sum of every node, splitting the nodes across threads.
+ * @param nodes The nodes.
+ * @param threads The number of threads to use, or 0 for one per hardware thread.
+ * @return The key of each node, at the node's index.
+ */
+std::vector<unsigned int> ascii_keys(const std::vector<std::shared_ptr<BaseNode>>& nodes, unsigned int threads = 0);
+
+/**
+ * @brief Sorts indices by their keys, splitting the work across threads.
+ *
+ * Integer keys usually span a small range, so they are bucketed in O(n) passes: a single
+ * counting pass when the range is narrow, or LSD radix passes over its bytes. Each thread
+ * counts and scatters one chunk. Only a few keys over a wide range are comparison sorted.
+ * Every path is stable, so equal keys keep their index order and the result is the same
+ * for any number of threads.
+ *
+ * @param keys The key of each index.
+ * @param threads The number of threads to use, or 0 for one per hardware thread.
+ * @return The indices 0 .. keys.size()-1, ordered by key.
+ */
+std::vector<size_t> sort_by_key(const std::vector<unsigned int>& keys, unsigned int threads = 0);
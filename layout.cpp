@@ -0,0 +1,25 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "layout.hpp"
+
+// The root is centered horizontally near the top of the canvas
+NodeLayout root_layout(float width) {
+    return NodeLayout{width / 2, 50, width, 0.001};
+}
+
+// Children are spread evenly below their parent, narrowing with depth
+NodeLayout child_layout(const NodeLayout& parent, size_t index, size_t count) {
+    float childY = parent.y + 2 * NODE_RADIUS + 60;  // Adjust vertical distance between nodes
+    float adjustedXOffset = static_cast<float>(parent.xOffset / (parent.depth + 0.9));  // Adjust horizontal spread based on depth
+    if (parent.depth == 1) adjustedXOffset = parent.xOffset;  // Significant spread for the first level
+
+    float startX = parent.x - (adjustedXOffset / 2);
+    float childX = startX + static_cast<float>(index + 1) * (adjustedXOffset / static_cast<float>(count + 1));
+
+    // Further decrease horizontal spread for the next level
+    return NodeLayout{childX, childY, static_cast<float>(parent.xOffset * 0.7), parent.depth + 1};
+}
@@ -0,0 +1,42 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include <cstddef>
+
+// Radius of the circle drawn for every node.
+constexpr float NODE_RADIUS = 35.0f;
+
+/**
+ * @struct NodeLayout
+ * @brief Position of a node on the canvas and the spread left for its children.
+ *
+ * Shared by the SFML renderer and the exporters so that every output draws the
+ * tree the same way.
+ */
+struct NodeLayout {
+    float x;        // x-coordinate of the node's center.
+    float y;        // y-coordinate of the node's center.
+    float xOffset;  // Horizontal spread available to the node's children.
+    double depth;   // Depth factor used to narrow the spread level by level.
+};
+
+/**
+ * @brief Computes the layout of the root node.
+ * @param width Width of the canvas.
+ * @return The layout of the root node.
+ */
+NodeLayout root_layout(float width);
+
+/**
+ * @brief Computes the layout of a child from the layout of its parent.
+ * @param parent The layout of the parent node.
+ * @param index The index of the child among its siblings.
+ * @param count The number of children the parent has.
+ * @return The layout of the child node.
+ */
+NodeLayout child_layout(const NodeLayout& parent, size_t index, size_t count);
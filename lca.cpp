@@ -0,0 +1,149 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "lca.hpp"
+#include <stdexcept>
+#include <utility>
+
+// LcaIndex implementations
+
+// Builds the sparse table level by level from the entry order
+LcaIndex::LcaIndex(std::shared_ptr<const EulerIndex> eulerIndex) : euler(std::move(eulerIndex)) {
+    size_t n = euler->size();
+    if (n == 0) return;
+
+    table.emplace_back(n);
+    for (size_t i = 0; i < n; ++i) {
+        table[0][i] = static_cast<uint32_t>(i);
+    }
+
+    // Each level combines two overlapping windows of the level below
+    for (size_t k = 1; (size_t{1} << k) <= n; ++k) {
+        size_t half = size_t{1} << (k - 1);
+        size_t count = n - (size_t{1} << k) + 1;
+        std::vector<uint32_t> level(count);
+        for (size_t i = 0; i < count; ++i) {
+            level[i] = shallower(table[k - 1][i], table[k - 1][i + half]);
+        }
+        table.push_back(std::move(level));
+    }
+}
+
+uint32_t LcaIndex::shallower(uint32_t a, uint32_t b) const {
+    return euler->depth(b) < euler->depth(a) ? b : a;
+}
+
+// Answers the query with one range-minimum lookup over the entry order
+size_t LcaIndex::lca(size_t a, size_t b) const {
+    if (a == b) return a;
+    if (a > b) std::swap(a, b);
+
+    // The shallowest node entered in (a, b] is a child of the LCA
+    size_t from = a + 1;
+    size_t length = b - from + 1;
+    size_t k = 0;
+    while ((size_t{2} << k) <= length) {
+        ++k;
+    }
+    uint32_t lowest = shallower(table[k][from], table[k][b + 1 - (size_t{1} << k)]);
+    return euler->parent(lowest);
+}
+
+BaseNode* LcaIndex::lca(const BaseNode* a, const BaseNode* b) const {
+    return euler->node_at(lca(euler->id_of(a), euler->id_of(b)));
+}
+
+// IncrementalLca implementations
+
+// Indexes the existing tree in BFS order so every parent precedes its children
+IncrementalLca::IncrementalLca(BaseNode* root) {
+    up.emplace_back();
+    if (!root) return;
+
+    append(root, 0);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        for (auto& child : nodes[i]->children) {
+            if (child == nullptr) {
+                throw std::runtime_error("Error: Encountered null or invalid child node!");
+            }
+            append(child.get(), static_cast<uint32_t>(i));
+        }
+    }
+}
+
+// Adds one node, growing the lifting table by a level when the tree gets deeper
+void IncrementalLca::append(BaseNode* node, uint32_t parent) {
+    uint32_t id = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(node);
+    ids.emplace(node, id);
+
+    // The first node is the root and is its own ancestor
+    depths.push_back(id == 0 ? 0 : depths[parent] + 1);
+    up[0].push_back(id == 0 ? 0 : parent);
+    for (size_t k = 1; k < up.size(); ++k) {
+        up[k].push_back(up[k - 1][up[k - 1][id]]);
+    }
+
+    // A new level is needed once a jump of 2^levels fits inside the depth
+    if ((uint64_t{1} << up.size()) <= depths[id]) {
+        const std::vector<uint32_t>& below = up.back();
+        std::vector<uint32_t> level(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            level[i] = below[below[i]];
+        }
+        up.push_back(std::move(level));
+    }
+}
+
+bool IncrementalLca::contains(const BaseNode* node) const {
+    return ids.find(node) != ids.end();
+}
+
+// Indexes the child and its whole subtree, parents before children
+void IncrementalLca::add_node(const BaseNode* parent, BaseNode* child) {
+    auto it = ids.find(parent);
+    if (it == ids.end()) {
+        throw std::runtime_error("Error: Node is not part of the tree!");
+    }
+
+    size_t first = nodes.size();
+    append(child, it->second);
+    for (size_t i = first; i < nodes.size(); ++i) {
+        for (auto& grandchild : nodes[i]->children) {
+            if (grandchild == nullptr) {
+                throw std::runtime_error("Error: Encountered null or invalid child node!");
+            }
+            append(grandchild.get(), static_cast<uint32_t>(i));
+        }
+    }
+}
+
+// Lifts the deeper node to the same depth, then lifts both just below the LCA
+BaseNode* IncrementalLca::lca(const BaseNode* a, const BaseNode* b) const {
+    auto itA = ids.find(a);
+    auto itB = ids.find(b);
+    if (itA == ids.end() || itB == ids.end()) {
+        throw std::runtime_error("Error: Node is not part of the tree!");
+    }
+
+    uint32_t u = itA->second;
+    uint32_t v = itB->second;
+    if (depths[u] < depths[v]) std::swap(u, v);
+
+    uint32_t diff = depths[u] - depths[v];
+    for (size_t k = 0; diff != 0; ++k, diff >>= 1) {
+        if (diff & 1u) u = up[k][u];
+    }
+    if (u == v) return nodes[u];
+
+    for (size_t k = up.size(); k > 0; --k) {
+        if (up[k - 1][u] != up[k - 1][v]) {
+            u = up[k - 1][u];
+            v = up[k - 1][v];
+        }
+    }
+    return nodes[up[0][u]];
+}
@@ -0,0 +1,109 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "node.hpp"
+#include "euler_index.hpp"
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @class LcaIndex
+ * @brief Lowest common ancestor queries in O(1) after an O(n log n) build.
+ *
+ * Uses the Euler tour entry order of an EulerIndex: for two nodes entered at times
+ * a < b, the shallowest node entered in (a, b] is a child of their LCA. A sparse
+ * table answers that range-minimum query with two lookups. Like the EulerIndex it is
+ * built on, the index is a snapshot of the tree.
+ */
+class LcaIndex {
+private:
+    std::shared_ptr<const EulerIndex> euler;    // Entry order, depths and parents of the nodes.
+    std::vector<std::vector<uint32_t>> table;   // table[k][i] is the shallowest id in [i, i + 2^k).
+
+    /**
+     * @brief Picks the shallower of two nodes.
+     */
+    uint32_t shallower(uint32_t a, uint32_t b) const;
+
+public:
+    /**
+     * @brief Builds the sparse table over the entry order of an Euler index.
+     * @param euler The Euler index of the tree.
+     */
+    explicit LcaIndex(std::shared_ptr<const EulerIndex> euler);
+
+    /**
+     * @brief Finds the lowest common ancestor of two nodes by id.
+     * @param a The id of the first node.
+     * @param b The id of the second node.
+     * @return The id of the lowest common ancestor.
+     */
+    size_t lca(size_t a, size_t b) const;
+
+    /**
+     * @brief Finds the lowest common ancestor of two nodes.
+     * @param a The first node.
+     * @param b The second node.
+     * @return The lowest common ancestor.
+     * @throw std::runtime_error if either node is not in the tree.
+     */
+    BaseNode* lca(const BaseNode* a, const BaseNode* b) const;
+};
+
+/**
+ * @class IncrementalLca
+ * @brief Lowest common ancestor queries by binary lifting, kept current as nodes are added.
+ *
+ * Queries take O(log n). Unlike LcaIndex, adding a leaf costs O(log n) instead of a
+ * full rebuild, so it suits trees that keep growing between queries.
+ */
+class IncrementalLca {
+private:
+    std::vector<std::vector<uint32_t>> up;         // up[k][i] is the 2^k-th ancestor of node i (the root is its own).
+    std::vector<uint32_t> depths;                  // Depth of each node.
+    std::vector<BaseNode*> nodes;                  // Nodes by id, in insertion order.
+    std::unordered_map<const BaseNode*, uint32_t> ids;  // Id of each node.
+
+    /**
+     * @brief Appends a single node under an already indexed parent.
+     */
+    void append(BaseNode* node, uint32_t parent);
+
+public:
+    /**
+     * @brief Indexes every node of an existing tree.
+     * @param root Pointer to the root node (may be null).
+     * @throw std::runtime_error if a null child is encountered.
+     */
+    explicit IncrementalLca(BaseNode* root);
+
+    /**
+     * @brief Checks whether a node is indexed.
+     * @param node The node to look up.
+     * @return True if the node is indexed.
+     */
+    bool contains(const BaseNode* node) const;
+
+    /**
+     * @brief Indexes a new child and every node below it.
+     * @param parent An indexed node the child was attached to.
+     * @param child The new child.
+     * @throw std::runtime_error if the parent is not indexed or a null child is encountered.
+     */
+    void add_node(const BaseNode* parent, BaseNode* child);
+
+    /**
+     * @brief Finds the lowest common ancestor of two nodes.
+     * @param a The first node.
+     * @param b The second node.
+     * @return The lowest common ancestor.
+     * @throw std::runtime_error if either node is not indexed.
+     */
+    BaseNode* lca(const BaseNode* a, const BaseNode* b) const;
+};
@@ -0,0 +1,61 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "level_index.hpp"
+#include <stdexcept>
+
+// Builds the index one level at a time, appending the children of each level after it
+LevelIndex::LevelIndex(BaseNode* root) {
+    offsets.push_back(0);
+    if (!root) return;
+
+    order.push_back(root);
+    depths.emplace(root, 0);
+    size_t levelStart = 0;
+    while (levelStart < order.size()) {
+        size_t levelEnd = order.size();
+        size_t depth = offsets.size();
+        offsets.push_back(levelEnd);
+
+        for (size_t i = levelStart; i < levelEnd; ++i) {
+            for (auto& child : order[i]->children) {
+                if (child == nullptr) {
+                    throw std::runtime_error("Error: Encountered null or invalid child node!");
+                }
+                order.push_back(child.get());
+                depths.emplace(child.get(), depth);
+            }
+        }
+        levelStart = levelEnd;
+    }
+}
+
+NodeRange LevelIndex::nodes_at_depth(size_t depth) const {
+    if (depth >= level_count()) {
+        return NodeRange{nullptr, nullptr};
+    }
+    return NodeRange{order.data() + offsets[depth], order.data() + offsets[depth + 1]};
+}
+
+size_t LevelIndex::depth_of(const BaseNode* node) const {
+    auto it = depths.find(node);
+    if (it == depths.end()) {
+        throw std::runtime_error("Error: Node is not part of the tree!");
+    }
+    return it->second;
+}
+
+size_t LevelIndex::level_count() const {
+    return offsets.size() - 1;
+}
+
+size_t LevelIndex::height() const {
+    return level_count() == 0 ? 0 : level_count() - 1;
+}
+
+NodeRange LevelIndex::nodes() const {
+    return NodeRange{order.data(), order.data() + order.size()};
+}
@@ -0,0 +1,82 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "node.hpp"
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @struct NodeRange
+ * @brief A read-only view over a contiguous run of node pointers.
+ */
+struct NodeRange {
+    BaseNode* const* first;  // First node of the range.
+    BaseNode* const* last;   // One past the last node of the range.
+
+    BaseNode* const* begin() const { return first; }
+    BaseNode* const* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    BaseNode* operator[](size_t i) const { return first[i]; }
+};
+
+/**
+ * @class LevelIndex
+ * @brief The nodes of a tree in BFS order, with the offset where every level starts.
+ *
+ * All the nodes at depth d are stored contiguously between offsets[d] and
+ * offsets[d + 1], so a whole level is available without running a BFS. The index is
+ * a snapshot: it must be rebuilt after the tree changes.
+ */
+class LevelIndex {
+private:
+    std::vector<BaseNode*> order;    // Nodes in BFS order.
+    std::vector<size_t> offsets;     // Start of every level in order, plus the end of the last one.
+    std::unordered_map<const BaseNode*, size_t> depths;  // Depth of each node.
+
+public:
+    /**
+     * @brief Builds the index in one BFS pass.
+     * @param root Pointer to the root node (may be null).
+     * @throw std::runtime_error if a null child is encountered.
+     */
+    explicit LevelIndex(BaseNode* root);
+
+    /**
+     * @brief Gets the nodes at a given depth, left to right.
+     * @param depth The depth of the level (the root is at depth 0).
+     * @return The nodes of the level, empty if the tree is not that deep.
+     */
+    NodeRange nodes_at_depth(size_t depth) const;
+
+    /**
+     * @brief Gets the depth of a node.
+     * @param node The node to look up.
+     * @return The depth of the node.
+     * @throw std::runtime_error if the node is not in the tree.
+     */
+    size_t depth_of(const BaseNode* node) const;
+
+    /**
+     * @brief Gets the number of levels in the tree.
+     * @return The number of levels, 0 for an empty tree.
+     */
+    size_t level_count() const;
+
+    /**
+     * @brief Gets the height of the tree, the number of edges on its longest downward path.
+     * @return The height, 0 for an empty or single node tree.
+     */
+    size_t height() const;
+
+    /**
+     * @brief Gets all the nodes in BFS order.
+     * @return The nodes of the tree.
+     */
+    NodeRange nodes() const;
+};
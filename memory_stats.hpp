@@ -0,0 +1,91 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief Memory occupied by the nodes of a tree, by category.
+ */
+struct MemoryStats {
+    size_t nodes = 0;                // Number of nodes.
+    size_t nodeBytes = 0;            // Node objects, including their value members.
+    size_t controlBlockBytes = 0;    // shared_ptr control blocks around the nodes.
+    size_t childArrayUsedBytes = 0;  // Child pointers actually stored.
+    size_t childArrayBytes = 0;      // Child arrays as allocated, including unused capacity.
+    size_t valueBytes = 0;           // Value storage outside the nodes, such as long strings.
+
+    /**
+     * @brief Gets the total memory, counting child arrays at their capacity.
+     * @return The total in bytes.
+     */
+    size_t total() const {
+        return nodeBytes + controlBlockBytes + childArrayBytes + valueBytes;
+    }
+};
+
+/**
+ * @brief Allocator that reports the size of the block it allocates through a pointer.
+ *
+ * Passed to allocate_shared, it is rebound to the type that make_shared allocates in one
+ * block: the control block with the object inside. Each probe writes to its own variable,
+ * so measurements on different threads do not interfere.
+ *
+ * @tparam T The type to allocate.
+ */
+template <typename T>
+struct BlockSizeProbe {
+    using value_type = T;
+
+    size_t* size;  // Where the size of the allocated block is written.
+
+    /**
+     * @brief Creates a probe writing to the given variable.
+     * @param out The variable that receives the block size.
+     */
+    explicit BlockSizeProbe(size_t* out) : size(out) {}
+
+    template <typename U>
+    BlockSizeProbe(const BlockSizeProbe<U>& other) : size(other.size) {}
+
+    T* allocate(size_t count) {
+        *size = sizeof(T) * count;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template <typename U>
+    bool operator==(const BlockSizeProbe<U>& other) const { return size == other.size; }
+
+    template <typename U>
+    bool operator!=(const BlockSizeProbe<U>& other) const { return size != other.size; }
+};
+
+/**
+ * @brief Get the bytes make_shared adds around an object of type T, measured once per type.
+ *
+ * The probe is kept in the block it measures, in front of the object, where make_shared's
+ * empty allocator takes no room; its size, padded to the object's alignment, is taken off.
+ *
+ * @tparam T The type of the object.
+ * @param args Arguments to construct a sample object with.
+ * @return The size of the control block, without the object.
+ */
+template <typename T, typename... Args>
+size_t make_shared_overhead(const Args&... args) {
+    static const size_t overhead = [&] {
+        size_t blockSize = 0;
+        std::allocate_shared<T>(BlockSizeProbe<T>(&blockSize), args...);
+        size_t probeSize = (sizeof(BlockSizeProbe<T>) + alignof(T) - 1) / alignof(T) * alignof(T);
+        return blockSize - probeSize - sizeof(T);
+    }();
+    return overhead;
+}
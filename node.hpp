@@ -15,6 +15,7 @@
 #include <stdexcept>
 #include <memory>
 #include "Complex.hpp"
+#include "memory_stats.hpp"
 
 /**
  * @class BaseNode - abstract class
@@ -36,6 +37,30 @@ public:
      */
     virtual unsigned int get_ascii_value() const = 0;
 
+    /**
+     * @brief Create a new node holding a copy of this node's value and no children.
+     * @return The new node.
+     */
+    virtual std::shared_ptr<BaseNode> clone() const = 0;
+
+    /**
+     * @brief Get the size of the node object itself.
+     * @return The size in bytes.
+     */
+    virtual size_t node_bytes() const = 0;
+
+    /**
+     * @brief Get the size of the shared_ptr control block that make_shared allocates with the node.
+     * @return The size in bytes, not counting the node object.
+     */
+    virtual size_t control_block_bytes() const = 0;
+
+    /**
+     * @brief Get the heap memory owned by the value outside the node object.
+     * @return The size in bytes.
+     */
+    virtual size_t value_heap_bytes() const = 0;
+
     // Vector to store child nodes
     std::vector<std::shared_ptr<BaseNode>> children;
 
@@ -118,4 +143,47 @@ public:
 
         return ascii_sum;  // Return the ASCII sum
     }
+
+    /**
+     * @brief Create a new node holding a copy of this node's value and no children.
+     * @return The new node.
+     */
+    std::shared_ptr<BaseNode> clone() const override {
+        return std::make_shared<Node<T>>(value);
+    }
+
+    /**
+     * @brief Get the size of the node object itself.
+     * @return The size in bytes.
+     */
+    size_t node_bytes() const override {
+        return sizeof(Node<T>);
+    }
+
+    /**
+     * @brief Get the size of the shared_ptr control block that make_shared allocates with the node.
+     * @return The size in bytes, not counting the node object.
+     */
+    size_t control_block_bytes() const override {
+        return make_shared_overhead<Node<T>>(value);
+    }
+
+    /**
+     * @brief Get the heap memory owned by the value outside the node object.
+     * @return The size in bytes.
+     */
+    size_t value_heap_bytes() const override {
+        if constexpr (std::is_same_v<T, std::string>) {
+            // Short strings are stored inside the string object itself
+            const char* object = reinterpret_cast<const char*>(&value);
+            if (value.data() >= object && value.data() < object + sizeof(value)) {
+                return 0;
+            }
+            return value.capacity() + 1;  // Including the terminating null character
+        }
+
+        else {
+            return 0;  // Numbers and complex numbers live entirely inside the node
+        }
+    }
 };
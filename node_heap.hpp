@@ -0,0 +1,267 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "tree.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Key extractor ordering nodes by the ASCII sum of their value, like myHeap.
+ * @param node The node.
+ * @return The ASCII sum.
+ */
+inline unsigned int ascii_key(const BaseNode* node) {
+    return node->get_ascii_value();
+}
+
+/**
+ * @brief Key extractor ordering nodes of type Node<T> by their value.
+ * @tparam T The type of the value.
+ */
+template <typename T>
+struct NumericKey {
+    /**
+     * @brief Gets the value of a node.
+     * @param node The node.
+     * @return The value.
+     * @throw std::runtime_error if the node does not hold a T.
+     */
+    T operator()(const BaseNode* node) const {
+        auto typed = dynamic_cast<const Node<T>*>(node);
+        if (!typed) {
+            throw std::runtime_error("Error: Node does not hold a value of the key type!");
+        }
+        return typed->value;
+    }
+};
+
+/**
+ * @brief A d-ary min-heap of tree nodes with a pluggable key extractor.
+ *
+ * Entries live in one array; the children of entry i are at d*i+1 .. d*i+d. A position map
+ * from node to entry makes decrease_key O(log_d n). Nodes with equal keys come out in the
+ * order they were pushed.
+ *
+ * @tparam Key The key type, compared with operator<.
+ */
+template <typename Key = unsigned int>
+class NodeHeap {
+public:
+    using KeyExtractor = std::function<Key(const BaseNode*)>;
+
+private:
+    struct Entry {
+        Key key;         // Priority of the node.
+        uint64_t order;  // Push sequence number, breaking ties between equal keys.
+        BaseNode* node;  // The node.
+    };
+
+    size_t arity;                                          // Number of children of each entry.
+    KeyExtractor keyOf;                                    // Computes the key of a pushed node.
+    std::vector<Entry> entries;                            // The heap in array order.
+    std::unordered_map<const BaseNode*, size_t> positions; // Index of each node in entries.
+    uint64_t pushes = 0;                                   // Number of pushes so far.
+
+    // Whether entry a comes out before entry b
+    static bool before(const Entry& a, const Entry& b) {
+        if (a.key < b.key) return true;
+        if (b.key < a.key) return false;
+        return a.order < b.order;
+    }
+
+    // Puts an entry at an index and records its position
+    void place(size_t index, Entry entry) {
+        positions[entry.node] = index;
+        entries[index] = std::move(entry);
+    }
+
+    // Moves the entry at index up until its parent comes before it
+    void sift_up(size_t index) {
+        Entry moving = std::move(entries[index]);
+        while (index > 0) {
+            size_t parent = (index - 1) / arity;
+            if (!before(moving, entries[parent])) break;
+            place(index, std::move(entries[parent]));
+            index = parent;
+        }
+        place(index, std::move(moving));
+    }
+
+    // Moves the entry at index down until it comes before all its children
+    void sift_down(size_t index) {
+        Entry moving = std::move(entries[index]);
+        while (true) {
+            size_t first = arity * index + 1;
+            if (first >= entries.size()) break;
+            size_t last = std::min(first + arity, entries.size());
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (before(entries[child], entries[best])) best = child;
+            }
+            if (!before(entries[best], moving)) break;
+            place(index, std::move(entries[best]));
+            index = best;
+        }
+        place(index, std::move(moving));
+    }
+
+    // Finds the entry of a node
+    size_t position_of(const BaseNode* node) const {
+        auto it = positions.find(node);
+        if (it == positions.end()) {
+            throw std::runtime_error("Error: Node is not in the heap!");
+        }
+        return it->second;
+    }
+
+public:
+    /**
+     * @brief Creates an empty heap.
+     * @param arity Number of children of each heap entry, at least 2.
+     * @param key Computes the key of a node pushed without one.
+     * @throw std::runtime_error if the arity is below 2.
+     */
+    explicit NodeHeap(size_t arity = 2, KeyExtractor key = ascii_key) : arity(arity), keyOf(std::move(key)) {
+        if (arity < 2) {
+            throw std::runtime_error("Error: Heap arity must be at least 2!");
+        }
+    }
+
+    /**
+     * @brief Creates a heap of every node of a tree, with the tree's maximum degree as arity.
+     *
+     * The nodes are added in BFS order and heapified bottom-up in O(n).
+     *
+     * @param tree The tree.
+     * @param key Computes the key of each node.
+     * @throw std::runtime_error if the tree's maximum degree is below 2.
+     */
+    explicit NodeHeap(const Tree& tree, KeyExtractor key = ascii_key) : NodeHeap(tree.get_max_degree(), std::move(key)) {
+        for (auto it = tree.begin_bfs(); it != tree.end_bfs(); ++it) {
+            entries.push_back({keyOf(*it), pushes++, *it});
+            positions[*it] = entries.size() - 1;
+        }
+        if (entries.size() > 1) {
+            for (size_t index = (entries.size() - 2) / arity + 1; index-- > 0;) {
+                sift_down(index);  // From the last entry with children up to the root
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the number of nodes in the heap.
+     * @return The number of nodes.
+     */
+    size_t size() const {
+        return entries.size();
+    }
+
+    /**
+     * @brief Checks whether the heap is empty.
+     * @return True if there are no nodes.
+     */
+    bool empty() const {
+        return entries.empty();
+    }
+
+    /**
+     * @brief Checks whether a node is in the heap.
+     * @param node The node.
+     * @return True if the node is in the heap.
+     */
+    bool contains(const BaseNode* node) const {
+        return positions.count(node) != 0;
+    }
+
+    /**
+     * @brief Adds a node, computing its key with the key extractor.
+     * @param node The node.
+     * @throw std::runtime_error if the node is null or already in the heap.
+     */
+    void push(BaseNode* node) {
+        if (!node) {
+            throw std::runtime_error("Error: Cannot push a null node!");
+        }
+        push(node, keyOf(node));
+    }
+
+    /**
+     * @brief Adds a node with an explicit key.
+     * @param node The node.
+     * @param key The key.
+     * @throw std::runtime_error if the node is null or already in the heap.
+     */
+    void push(BaseNode* node, Key key) {
+        if (!node) {
+            throw std::runtime_error("Error: Cannot push a null node!");
+        }
+        if (contains(node)) {
+            throw std::runtime_error("Error: Node is already in the heap!");
+        }
+        entries.push_back({std::move(key), pushes++, node});
+        sift_up(entries.size() - 1);
+    }
+
+    /**
+     * @brief Gets the node with the smallest key.
+     * @return The node.
+     * @throw std::runtime_error if the heap is empty.
+     */
+    BaseNode* top() const {
+        if (entries.empty()) {
+            throw std::runtime_error("Error: Heap is empty!");
+        }
+        return entries.front().node;
+    }
+
+    /**
+     * @brief Gets the current key of a node.
+     * @param node The node.
+     * @return The key.
+     * @throw std::runtime_error if the node is not in the heap.
+     */
+    const Key& key_of(const BaseNode* node) const {
+        return entries[position_of(node)].key;
+    }
+
+    /**
+     * @brief Removes the node with the smallest key.
+     * @return The node.
+     * @throw std::runtime_error if the heap is empty.
+     */
+    BaseNode* pop_min() {
+        BaseNode* node = top();
+        positions.erase(node);
+        Entry last = std::move(entries.back());
+        entries.pop_back();
+        if (!entries.empty()) {
+            entries.front() = std::move(last);
+            sift_down(0);
+        }
+        return node;
+    }
+
+    /**
+     * @brief Lowers the key of a node in the heap.
+     * @param node The node.
+     * @param key The new key, not greater than the current one.
+     * @throw std::runtime_error if the node is not in the heap or the key is greater.
+     */
+    void decrease_key(const BaseNode* node, Key key) {
+        size_t index = position_of(node);
+        if (entries[index].key < key) {
+            throw std::runtime_error("Error: New key is greater than the current key!");
+        }
+        entries[index].key = std::move(key);
+        sift_up(index);
+    }
+};
@@ -0,0 +1,54 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "path_copy.hpp"
+#include <stdexcept>
+
+// Depth-first search keeping the current path as a stack of (node, next child) frames
+bool find_path(BaseNode* root, const BaseNode* target, std::vector<size_t>& path) {
+    path.clear();
+    if (!root) return false;
+    if (root == target) return true;
+
+    std::vector<std::pair<BaseNode*, size_t>> frames = {{root, 0}};
+    while (!frames.empty()) {
+        auto& [node, next] = frames.back();
+        if (next == node->children.size()) {
+            frames.pop_back();
+            continue;
+        }
+
+        BaseNode* child = node->children[next++].get();
+        if (child == nullptr) {
+            throw std::runtime_error("Error: Encountered null or invalid child node!");
+        }
+        if (child == target) {
+            // Every frame's next child is one past the child taken on the path
+            for (const auto& frame : frames) {
+                path.push_back(frame.second - 1);
+            }
+            return true;
+        }
+        frames.push_back({child, 0});
+    }
+    return false;
+}
+
+// Clones the nodes on the path top-down, each copy taking over its original's children
+PathCopy copy_path(const BaseNode* root, const std::vector<size_t>& path) {
+    std::shared_ptr<BaseNode> newRoot = root->clone();
+    newRoot->children = root->children;
+
+    BaseNode* copy = newRoot.get();
+    for (size_t index : path) {
+        const std::shared_ptr<BaseNode>& original = copy->children.at(index);
+        std::shared_ptr<BaseNode> next = original->clone();
+        next->children = original->children;
+        copy->children[index] = next;
+        copy = next.get();
+    }
+    return PathCopy{newRoot, copy};
+}
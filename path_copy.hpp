@@ -0,0 +1,42 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "node.hpp"
+#include <vector>
+
+/**
+ * @struct PathCopy
+ * @brief Result of copying the path from a root down to one of its nodes.
+ */
+struct PathCopy {
+    std::shared_ptr<BaseNode> root;  // Copy of the root, sharing every subtree off the path.
+    BaseNode* target;                // Copy of the node at the end of the path.
+};
+
+/**
+ * @brief Finds the child indices leading from a root to a node.
+ * @param root The node to start from.
+ * @param target The node to find.
+ * @param path Filled with the index of the child taken at each step (empty when target is root).
+ * @return True if target was found below root, false otherwise.
+ * @throw std::runtime_error if a null child is encountered.
+ */
+bool find_path(BaseNode* root, const BaseNode* target, std::vector<size_t>& path);
+
+/**
+ * @brief Copies the nodes along a path, sharing every other subtree with the original.
+ *
+ * The original nodes are left untouched, so any tree still holding the old root keeps
+ * seeing the old structure.
+ *
+ * @param root The root of the original version.
+ * @param path The child indices leading from root to the node to copy last.
+ * @return The new root and the copy of the last node on the path.
+ * @throw std::out_of_range if the path does not exist.
+ */
+PathCopy copy_path(const BaseNode* root, const std::vector<size_t>& path);
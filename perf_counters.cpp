@@ -0,0 +1,97 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "perf_counters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+
+// Opens one hardware counter for the calling thread, on any CPU
+static int open_counter(uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group == -1 ? 1 : 0;  // The leader starts the whole group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+// Opens the group and starts it, closing everything if any counter is missing
+PerfScope::PerfScope() {
+    const uint64_t configs[EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < EVENTS; ++i) {
+        fds[i] = -1;
+    }
+    for (int i = 0; i < EVENTS; ++i) {
+        fds[i] = open_counter(configs[i], i == 0 ? -1 : fds[0]);
+        if (fds[i] == -1) {
+            for (int j = 0; j < i; ++j) {
+                close(fds[j]);
+                fds[j] = -1;
+            }
+            return;
+        }
+    }
+    ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+// Closes the group
+PerfScope::~PerfScope() {
+    for (int fd : fds) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+}
+
+// Reads every counter of the group at once: the count of values, then the values
+PerfCounts PerfScope::read() const {
+    PerfCounts counts;
+    if (!available()) return counts;
+
+    uint64_t values[1 + EVENTS];
+    if (::read(fds[0], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[0] != EVENTS) {
+        return counts;
+    }
+    counts.valid = true;
+    counts.cycles = values[1];
+    counts.instructions = values[2];
+    counts.cacheMisses = values[3];
+    counts.branchMisses = values[4];
+    return counts;
+}
+
+#else
+
+// Without perf_event_open there is nothing to count
+PerfScope::PerfScope() {
+    for (int i = 0; i < EVENTS; ++i) {
+        fds[i] = -1;
+    }
+}
+
+PerfScope::~PerfScope() {}
+
+PerfCounts PerfScope::read() const {
+    return PerfCounts();
+}
+
+#endif
+
+// The group is open only if every counter was
+bool PerfScope::available() const {
+    return fds[0] != -1;
+}
@@ -0,0 +1,60 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Hardware event counts of one scope.
+ */
+struct PerfCounts {
+    bool valid = false;         // Whether the counters could be read; all counts are zero otherwise.
+    uint64_t cycles = 0;        // CPU cycles.
+    uint64_t instructions = 0;  // Instructions retired.
+    uint64_t cacheMisses = 0;   // Last-level cache misses.
+    uint64_t branchMisses = 0;  // Mispredicted branches.
+};
+
+/**
+ * @brief Counts hardware events of the current thread while the scope is alive.
+ *
+ * On Linux the counters are opened with perf_event_open as one group, so all four are
+ * scheduled together. When counters are not available (another platform, a virtual
+ * machine without a PMU, or a restrictive perf_event_paranoid setting), the scope does
+ * nothing and read() returns counts marked invalid.
+ */
+class PerfScope {
+private:
+    static constexpr int EVENTS = 4;  // cycles, instructions, cache misses, branch misses.
+    int fds[EVENTS];                   // Counter file descriptors, the first one leads the group.
+
+public:
+    /**
+     * @brief Opens and starts the counters.
+     */
+    PerfScope();
+
+    /**
+     * @brief Closes the counters.
+     */
+    ~PerfScope();
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+    /**
+     * @brief Checks whether the counters are running.
+     * @return True if the counts are available.
+     */
+    bool available() const;
+
+    /**
+     * @brief Reads the counts since the start of the scope.
+     * @return The counts, marked invalid if the counters are not available.
+     */
+    PerfCounts read() const;
+};
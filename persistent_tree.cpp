@@ -0,0 +1,71 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "persistent_tree.hpp"
+#include "path_copy.hpp"
+#include <stdexcept>
+
+// Constructor starts with an empty tree as version 0
+PersistentTree::PersistentTree(unsigned int degree) : maxDegree(degree) {
+    versions.emplace_back(degree);
+}
+
+size_t PersistentTree::commit(std::shared_ptr<BaseNode> root) {
+    Tree tree(maxDegree);
+    tree.add_root(root);
+    versions.push_back(tree);
+    return versions.size() - 1;
+}
+
+size_t PersistentTree::add_root(std::shared_ptr<BaseNode> root_node) {
+    return commit(root_node);
+}
+
+// Locates the parent in the requested version, then copies the path to it
+size_t PersistentTree::add_sub_node(size_t version, BaseNode* parent, std::shared_ptr<BaseNode> child) {
+    if (!parent || !child) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+
+    std::vector<size_t> path;
+    if (!find_path(versions.at(version).get_root(), parent, path)) {
+        throw std::runtime_error("Error: Node is not part of the tree!");
+    }
+    return add_sub_node(version, path, child);
+}
+
+// Copies the path to the parent and attaches the child to the copy
+size_t PersistentTree::add_sub_node(size_t version, const std::vector<size_t>& path, std::shared_ptr<BaseNode> child) {
+    const Tree& base = versions.at(version);
+    if (!base.get_root() || !child) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+
+    // Check the parent before copying anything, so a failure leaves the history unchanged
+    BaseNode* parent = base.get_root();
+    for (size_t index : path) {
+        parent = parent->children.at(index).get();
+    }
+    if (parent->children.size() >= maxDegree) {
+        throw std::runtime_error("Error: Cannot add child, maxDegree exceeded for parent node!");
+    }
+
+    PathCopy copy = copy_path(base.get_root(), path);
+    copy.target->add_child(child);
+    return commit(copy.root);
+}
+
+const Tree& PersistentTree::version(size_t version) const {
+    return versions.at(version);
+}
+
+const Tree& PersistentTree::latest() const {
+    return versions.back();
+}
+
+size_t PersistentTree::latest_version() const {
+    return versions.size() - 1;
+}
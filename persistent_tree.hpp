@@ -0,0 +1,94 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "tree.hpp"
+#include <deque>
+#include <vector>
+
+/**
+ * @class PersistentTree
+ * @brief A history of immutable tree versions that share their unchanged subtrees.
+ *
+ * Every mutation copies only the path from the root to the changed node and records
+ * the result as a new version; all the older versions stay readable through the usual
+ * Tree iterators. Versions are exposed read-only, and their nodes must not be modified
+ * directly since they may be shared with other versions.
+ */
+class PersistentTree {
+private:
+    std::deque<Tree> versions;   // Every version, oldest first (a deque keeps references stable).
+    unsigned int maxDegree;      // Maximum number of children each node can have.
+
+    /**
+     * @brief Records a new version rooted at the given node.
+     */
+    size_t commit(std::shared_ptr<BaseNode> root);
+
+public:
+    /**
+     * @brief Constructor starts the history with an empty version 0.
+     * @param degree Maximum number of children each node can have.
+     */
+    explicit PersistentTree(unsigned int degree = 2);
+
+    /**
+     * @brief Creates a version with a new root.
+     * @param root_node The new root node.
+     * @return The number of the new version.
+     */
+    size_t add_root(std::shared_ptr<BaseNode> root_node);
+
+    /**
+     * @brief Creates a version with a child added under a node of an existing version.
+     *
+     * The parent is located with a depth-first search, then only the path from the root
+     * to it is copied.
+     *
+     * @param version The version to start from.
+     * @param parent A node of that version.
+     * @param child The node to add.
+     * @return The number of the new version.
+     * @throw std::runtime_error if a node is null, the parent is not in the version or is full.
+     * @throw std::out_of_range if the version does not exist.
+     */
+    size_t add_sub_node(size_t version, BaseNode* parent, std::shared_ptr<BaseNode> child);
+
+    /**
+     * @brief Creates a version with a child added under the node at the end of a path.
+     *
+     * Unlike the node based overload, no search is needed: the update costs O(depth).
+     *
+     * @param version The version to start from.
+     * @param path The child indices leading from the root to the parent.
+     * @param child The node to add.
+     * @return The number of the new version.
+     * @throw std::runtime_error if the version is empty, the child is null or the parent is full.
+     * @throw std::out_of_range if the version or path does not exist.
+     */
+    size_t add_sub_node(size_t version, const std::vector<size_t>& path, std::shared_ptr<BaseNode> child);
+
+    /**
+     * @brief Gets a version.
+     * @param version The number of the version.
+     * @return The tree of that version.
+     * @throw std::out_of_range if the version does not exist.
+     */
+    const Tree& version(size_t version) const;
+
+    /**
+     * @brief Gets the most recent version.
+     * @return The tree of the latest version.
+     */
+    const Tree& latest() const;
+
+    /**
+     * @brief Gets the number of the most recent version.
+     * @return The number of the latest version.
+     */
+    size_t latest_version() const;
+};
@@ -0,0 +1,298 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "tree.hpp"
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @class TraversalRange
+ * @brief A begin/end pair of Tree iterators usable as a range.
+ * @tparam Iterator One of the Tree iterator types.
+ */
+template <typename Iterator>
+class TraversalRange {
+private:
+    Iterator first;  // Iterator at the start of the traversal.
+    Iterator last;   // Iterator at the end of the traversal.
+
+public:
+    using iterator = Iterator;
+
+    TraversalRange(Iterator first, Iterator last) : first(std::move(first)), last(std::move(last)) {}
+
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
+};
+
+/**
+ * @brief Gets the BFS traversal of a tree as a range.
+ */
+inline TraversalRange<Tree::BFSIterator> bfs_range(const Tree& tree) {
+    return {tree.begin_bfs(), tree.end_bfs()};
+}
+
+/**
+ * @brief Gets the DFS traversal of a tree as a range.
+ */
+inline TraversalRange<Tree::DFSIterator> dfs_range(const Tree& tree) {
+    return {tree.begin_dfs(), tree.end_dfs()};
+}
+
+/**
+ * @brief Gets the pre-order traversal of a tree as a range.
+ */
+inline TraversalRange<Tree::PreOrderIterator> pre_order_range(const Tree& tree) {
+    return {tree.begin_pre_order(), tree.end_pre_order()};
+}
+
+/**
+ * @brief Gets the post-order traversal of a tree as a range.
+ */
+inline TraversalRange<Tree::PostOrderIterator> post_order_range(const Tree& tree) {
+    return {tree.begin_post_order(), tree.end_post_order()};
+}
+
+/**
+ * @brief Gets the in-order traversal of a tree as a range.
+ */
+inline TraversalRange<Tree::InOrderIterator> in_order_range(const Tree& tree) {
+    return {tree.begin_in_order(), tree.end_in_order()};
+}
+
+/**
+ * @class FilterView
+ * @brief Lazily keeps the elements of a range matching a predicate.
+ */
+template <typename Base, typename Pred>
+class FilterView {
+private:
+    Base base;  // The adapted range.
+    Pred pred;  // The predicate elements must match.
+
+public:
+    class iterator {
+    private:
+        typename Base::iterator current;  // Position in the adapted range.
+        typename Base::iterator last;     // End of the adapted range.
+        Pred pred;                        // The predicate elements must match.
+
+        // Moves forward to the next matching element
+        void satisfy() {
+            while (current != last && !pred(*current)) {
+                ++current;
+            }
+        }
+
+    public:
+        iterator(typename Base::iterator current, typename Base::iterator last, Pred pred)
+            : current(std::move(current)), last(std::move(last)), pred(std::move(pred)) {
+            satisfy();
+        }
+
+        decltype(auto) operator*() { return *current; }
+
+        iterator& operator++() {
+            ++current;
+            satisfy();
+            return *this;
+        }
+
+        bool operator!=(const iterator&) const { return current != last; }
+    };
+
+    FilterView(Base base, Pred pred) : base(std::move(base)), pred(std::move(pred)) {}
+
+    iterator begin() const { return iterator(base.begin(), base.end(), pred); }
+    iterator end() const { return iterator(base.end(), base.end(), pred); }
+};
+
+/**
+ * @class TransformView
+ * @brief Lazily applies a function to every element of a range.
+ */
+template <typename Base, typename Fn>
+class TransformView {
+private:
+    Base base;  // The adapted range.
+    Fn fn;      // The function applied to each element.
+
+public:
+    class iterator {
+    private:
+        typename Base::iterator current;  // Position in the adapted range.
+        typename Base::iterator last;     // End of the adapted range.
+        Fn fn;                            // The function applied to each element.
+
+    public:
+        iterator(typename Base::iterator current, typename Base::iterator last, Fn fn)
+            : current(std::move(current)), last(std::move(last)), fn(std::move(fn)) {}
+
+        decltype(auto) operator*() { return fn(*current); }
+
+        iterator& operator++() {
+            ++current;
+            return *this;
+        }
+
+        bool operator!=(const iterator&) const { return current != last; }
+    };
+
+    TransformView(Base base, Fn fn) : base(std::move(base)), fn(std::move(fn)) {}
+
+    iterator begin() const { return iterator(base.begin(), base.end(), fn); }
+    iterator end() const { return iterator(base.end(), base.end(), fn); }
+};
+
+/**
+ * @class TakeView
+ * @brief Lazily stops a range after a number of elements.
+ */
+template <typename Base>
+class TakeView {
+private:
+    Base base;     // The adapted range.
+    size_t count;  // Maximum number of elements.
+
+public:
+    class iterator {
+    private:
+        typename Base::iterator current;  // Position in the adapted range.
+        typename Base::iterator last;     // End of the adapted range.
+        size_t remaining;                 // Number of elements still allowed.
+
+    public:
+        iterator(typename Base::iterator current, typename Base::iterator last, size_t remaining)
+            : current(std::move(current)), last(std::move(last)), remaining(remaining) {}
+
+        decltype(auto) operator*() { return *current; }
+
+        // The adapted range is not advanced past the last taken element
+        iterator& operator++() {
+            if (--remaining > 0) {
+                ++current;
+            }
+            return *this;
+        }
+
+        bool operator!=(const iterator&) const { return remaining > 0 && current != last; }
+    };
+
+    TakeView(Base base, size_t count) : base(std::move(base)), count(count) {}
+
+    iterator begin() const { return iterator(base.begin(), base.end(), count); }
+    iterator end() const { return iterator(base.end(), base.end(), 0); }
+};
+
+/**
+ * @class PruneView
+ * @brief Lazily drops every node matching a predicate together with its whole subtree.
+ *
+ * The descendants of a pruned node are never visited. The adapted range must be a
+ * pre-order or BFS traversal, whose iterators support skip_children().
+ */
+template <typename Base, typename Pred>
+class PruneView {
+private:
+    Base base;  // The adapted traversal.
+    Pred pred;  // The predicate selecting the subtrees to drop.
+
+public:
+    class iterator {
+    private:
+        typename Base::iterator current;  // Position in the adapted traversal.
+        typename Base::iterator last;     // End of the adapted traversal.
+        Pred pred;                        // The predicate selecting the subtrees to drop.
+
+        // Skips over pruned nodes without descending into them
+        void satisfy() {
+            while (current != last && pred(*current)) {
+                current.skip_children();
+                ++current;
+            }
+        }
+
+    public:
+        iterator(typename Base::iterator current, typename Base::iterator last, Pred pred)
+            : current(std::move(current)), last(std::move(last)), pred(std::move(pred)) {
+            satisfy();
+        }
+
+        BaseNode* operator*() { return *current; }
+
+        iterator& operator++() {
+            ++current;
+            satisfy();
+            return *this;
+        }
+
+        bool operator!=(const iterator&) const { return current != last; }
+    };
+
+    PruneView(Base base, Pred pred) : base(std::move(base)), pred(std::move(pred)) {}
+
+    iterator begin() const { return iterator(base.begin(), base.end(), pred); }
+    iterator end() const { return iterator(base.end(), base.end(), pred); }
+};
+
+// Adaptor objects holding the arguments until they are applied with operator|
+
+template <typename Pred>
+struct FilterAdaptor { Pred pred; };
+
+template <typename Fn>
+struct TransformAdaptor { Fn fn; };
+
+struct TakeAdaptor { size_t count; };
+
+template <typename Pred>
+struct PruneAdaptor { Pred pred; };
+
+/**
+ * @brief Keeps the elements matching a predicate: range | filter(pred).
+ */
+template <typename Pred>
+FilterAdaptor<Pred> filter(Pred pred) { return {std::move(pred)}; }
+
+/**
+ * @brief Applies a function to every element: range | transform(fn).
+ */
+template <typename Fn>
+TransformAdaptor<Fn> transform(Fn fn) { return {std::move(fn)}; }
+
+/**
+ * @brief Stops after a number of elements: range | take(n).
+ */
+inline TakeAdaptor take(size_t count) { return {count}; }
+
+/**
+ * @brief Drops the subtrees whose root matches a predicate: traversal | prune(pred).
+ */
+template <typename Pred>
+PruneAdaptor<Pred> prune(Pred pred) { return {std::move(pred)}; }
+
+template <typename Range, typename Pred>
+FilterView<std::decay_t<Range>, Pred> operator|(Range&& range, FilterAdaptor<Pred> adaptor) {
+    return {std::forward<Range>(range), std::move(adaptor.pred)};
+}
+
+template <typename Range, typename Fn>
+TransformView<std::decay_t<Range>, Fn> operator|(Range&& range, TransformAdaptor<Fn> adaptor) {
+    return {std::forward<Range>(range), std::move(adaptor.fn)};
+}
+
+template <typename Range>
+TakeView<std::decay_t<Range>> operator|(Range&& range, TakeAdaptor adaptor) {
+    return {std::forward<Range>(range), adaptor.count};
+}
+
+template <typename Range, typename Pred>
+PruneView<std::decay_t<Range>, Pred> operator|(Range&& range, PruneAdaptor<Pred> adaptor) {
+    return {std::forward<Range>(range), std::move(adaptor.pred)};
+}
@@ -0,0 +1,110 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "reclaimer.hpp"
+#include <atomic>
+
+// Set once the shared reclaimer is destroyed. Constant-initialized, so it is still valid
+// for destructors of statics that run after the reclaimer's
+static std::atomic<bool> sharedReclaimerGone{false};
+
+// Frees the nodes children first, keeping the call stack flat
+void release_nodes(std::vector<std::shared_ptr<BaseNode>>& nodes) {
+    while (!nodes.empty()) {
+        BaseNode* node = nodes.back().get();
+
+        // Only an exclusively owned node can be emptied; otherwise another owner keeps it alive
+        if (node && nodes.back().use_count() == 1 && !node->children.empty()) {
+            // Pair with the release of the last other owner, so its reads of the node come first
+            std::atomic_thread_fence(std::memory_order_acquire);
+            std::vector<std::shared_ptr<BaseNode>> children = std::move(node->children);
+            node->children.clear();
+            for (auto& child : children) {
+                nodes.push_back(std::move(child));
+            }
+            continue;
+        }
+        nodes.pop_back();
+    }
+}
+
+// Starts the worker
+Reclaimer::Reclaimer(bool isShared) : busy(false), stopping(false), shared(isShared), worker(&Reclaimer::run, this) {}
+
+// Starts a worker of its own
+Reclaimer::Reclaimer() : Reclaimer(false) {}
+
+// Lets the worker finish the queue, then joins it
+Reclaimer::~Reclaimer() {
+    if (shared) {
+        sharedReclaimerGone = true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+// Function-local static, so the thread only exists in programs that use it
+Reclaimer& Reclaimer::instance() {
+    static Reclaimer reclaimer(true);
+    return reclaimer;
+}
+
+// Uses the shared worker while it exists
+void Reclaimer::release(std::vector<std::shared_ptr<BaseNode>>& nodes) {
+    if (sharedReclaimerGone) {
+        release_nodes(nodes);
+    }
+    else {
+        instance().submit(nodes);
+    }
+}
+
+// Hands a batch over to the worker
+void Reclaimer::submit(std::vector<std::shared_ptr<BaseNode>>& nodes) {
+    if (nodes.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // The worker may already have exited, so a stopping reclaimer releases here
+        if (!stopping) {
+            queue.push_back(std::move(nodes));
+        }
+    }
+    if (!nodes.empty()) {
+        release_nodes(nodes);
+        return;
+    }
+    wake.notify_all();
+}
+
+// Blocks until the queue is empty and the worker is idle
+void Reclaimer::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.wait(lock, [this] { return queue.empty() && !busy; });
+}
+
+// Releases batches outside the lock until asked to stop
+void Reclaimer::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            return;  // Stopping, and nothing left to release
+        }
+
+        std::vector<std::shared_ptr<BaseNode>> batch = std::move(queue.front());
+        queue.pop_front();
+        busy = true;
+        lock.unlock();
+        release_nodes(batch);
+        lock.lock();
+        busy = false;
+        wake.notify_all();
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "node.hpp"
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+/**
+ * @brief Releases nodes in post-order with an explicit work list.
+ *
+ * Releasing a node through its shared_ptr destroys its children recursively, one stack
+ * frame per level, which overflows the stack on deep trees. Here a node that is owned only
+ * by the work list has its children moved onto the list first, so every node is freed as a
+ * leaf, after its children. Nodes still owned elsewhere just lose the reference.
+ *
+ * The flat stack is only guaranteed for the parts of the tree the list owns alone. A
+ * subtree whose root is also held by another shared_ptr is left to that owner, and is
+ * freed recursively when that owner drops it, unless it too goes through release_nodes.
+ *
+ * @param nodes The nodes to release. The vector is left empty.
+ */
+void release_nodes(std::vector<std::shared_ptr<BaseNode>>& nodes);
+
+/**
+ * @brief Background thread that releases nodes off the caller's thread.
+ */
+class Reclaimer {
+private:
+    std::deque<std::vector<std::shared_ptr<BaseNode>>> queue;  // Batches waiting to be released.
+    bool busy;                     // Whether the worker is releasing a batch.
+    bool stopping;                 // Whether the worker should exit once the queue is empty.
+    bool shared;                   // Whether this is the process-wide reclaimer.
+    std::mutex mutex;              // Guards the queue and the flags.
+    std::condition_variable wake;  // Signals new work, and the queue running empty.
+    std::thread worker;            // The releasing thread.
+
+    /**
+     * @brief Body of the worker thread.
+     */
+    void run();
+
+    /**
+     * @brief Starts the worker thread.
+     * @param isShared Whether this is the process-wide reclaimer.
+     */
+    explicit Reclaimer(bool isShared);
+
+public:
+    /**
+     * @brief Starts the worker thread.
+     */
+    Reclaimer();
+
+    /**
+     * @brief Releases whatever is still queued and joins the worker thread.
+     */
+    ~Reclaimer();
+
+    Reclaimer(const Reclaimer&) = delete;
+    Reclaimer& operator=(const Reclaimer&) = delete;
+
+    /**
+     * @brief Gets the process-wide reclaimer, starting it on first use.
+     * @return The shared reclaimer.
+     */
+    static Reclaimer& instance();
+
+    /**
+     * @brief Releases nodes on the shared worker thread, or inline once it has shut down.
+     *
+     * Use this rather than instance().submit() from destructors that may run during static
+     * destruction, after the shared reclaimer is gone.
+     *
+     * @param nodes The nodes to release. The vector is left empty.
+     */
+    static void release(std::vector<std::shared_ptr<BaseNode>>& nodes);
+
+    /**
+     * @brief Queues nodes to be released by the worker thread, or releases them inline if
+     * the reclaimer is stopping.
+     * @param nodes The nodes to release. The vector is left empty.
+     */
+    void submit(std::vector<std::shared_ptr<BaseNode>>& nodes);
+
+    /**
+     * @brief Waits until every queued batch has been released.
+     */
+    void drain();
+};
@@ -0,0 +1,134 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// One recorded span; the fields are atomic because a flush may read them while they are written
+struct TraceEvent {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> duration{0};
+};
+
+// Ring buffer of one thread, kept alive by the registry after the thread exits
+struct TraceBuffer {
+    size_t thread;                  // Track number in the output.
+    std::atomic<uint64_t> head{0};  // Number of spans ever written.
+    uint64_t flushed = 0;           // Number of spans already flushed, guarded by the registry mutex.
+    std::vector<TraceEvent> events;
+
+    explicit TraceBuffer(size_t thread) : thread(thread), events(TRACE_BUFFER_SIZE) {}
+};
+
+// Every buffer ever created, so a flush can reach the spans of all threads
+static std::mutex& registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::vector<std::shared_ptr<TraceBuffer>>& registry() {
+    static std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    return buffers;
+}
+
+// Nanoseconds since the first span of the process
+static uint64_t trace_now() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
+
+// Gets the calling thread's buffer, registering it on first use
+static TraceBuffer& local_buffer() {
+    thread_local std::shared_ptr<TraceBuffer> buffer = [] {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        auto created = std::make_shared<TraceBuffer>(registry().size() + 1);
+        registry().push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+// Starts timing
+TraceSpan::TraceSpan(const char* name) : name(name), start(trace_now()) {}
+
+// Writes the span to the next slot, then publishes it by advancing the head
+TraceSpan::~TraceSpan() {
+    uint64_t end = trace_now();
+    TraceBuffer& buffer = local_buffer();
+    uint64_t index = buffer.head.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer.events[index % TRACE_BUFFER_SIZE];
+
+    // Orders the overwrite after the head that made the slot's old span stale, for a concurrent flush
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.duration.store(end - start, std::memory_order_relaxed);
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+// Helper function to write a span name as a JSON string
+static void write_json_string(std::ostream& os, const char* text) {
+    os << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            os << '\\';
+        }
+        os << *c;
+    }
+    os << '"';
+}
+
+// Copies every buffer's new spans, skipping those a writer may have overwritten during the copy
+size_t flush_trace(std::ostream& os) {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    size_t written = 0;
+    os << "{\"traceEvents\":[";
+    for (const auto& buffer : registry()) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        // The oldest slot of a full ring is the next one to be overwritten, so it is never read
+        uint64_t first = head >= TRACE_BUFFER_SIZE ? std::max(buffer->flushed, head - TRACE_BUFFER_SIZE + 1) : buffer->flushed;
+
+        for (uint64_t index = first; index < head; ++index) {
+            const TraceEvent& event = buffer->events[index % TRACE_BUFFER_SIZE];
+            const char* name = event.name.load(std::memory_order_relaxed);
+            uint64_t start = event.start.load(std::memory_order_relaxed);
+            uint64_t duration = event.duration.load(std::memory_order_relaxed);
+
+            // Once the head has lapped the slot, the writer may be overwriting it
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer->head.load(std::memory_order_relaxed) >= index + TRACE_BUFFER_SIZE) {
+                continue;
+            }
+
+            os << (written++ ? ",\n" : "\n") << "{\"name\":";
+            write_json_string(os, name);
+            os << ",\"ph\":\"X\",\"ts\":" << start / 1000 << '.' << (start % 1000) / 100
+               << ",\"dur\":" << duration / 1000 << '.' << (duration % 1000) / 100
+               << ",\"pid\":1,\"tid\":" << buffer->thread << "}";
+        }
+        buffer->flushed = head;
+    }
+    os << "\n]}\n";
+    return written;
+}
+
+// Flushes into a file
+size_t flush_trace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Error: Cannot open trace file!");
+    }
+    return flush_trace(file);
+}
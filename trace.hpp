@@ -0,0 +1,116 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Records a span covering the rest of the enclosing block.
+ *
+ * Compiled out entirely unless TREE_TRACING is defined, so the instrumented Tree APIs cost
+ * nothing in normal builds. The name must be a string literal, only its pointer is stored.
+ */
+#ifdef TREE_TRACING
+#define TREE_TRACE_CONCAT_INNER(a, b) a##b
+#define TREE_TRACE_CONCAT(a, b) TREE_TRACE_CONCAT_INNER(a, b)
+#define TREE_TRACE_SPAN(name) TraceSpan TREE_TRACE_CONCAT(treeTraceSpan, __LINE__)(name)
+#else
+#define TREE_TRACE_SPAN(name) ((void)0)
+#endif
+
+/**
+ * @brief Size of each thread's ring buffer. A full ring flushes its newest
+ * TRACE_BUFFER_SIZE - 1 spans; older spans are overwritten.
+ */
+constexpr size_t TRACE_BUFFER_SIZE = 1 << 16;
+
+/**
+ * @brief Times the enclosing scope and records it in the current thread's ring buffer.
+ *
+ * Recording takes no lock: every thread writes only to its own buffer, and a flush reads
+ * the buffers without stopping the writers, dropping spans that were overwritten meanwhile.
+ */
+class TraceSpan {
+private:
+    const char* name;  // Name of the span.
+    uint64_t start;    // Start time in nanoseconds since the trace clock started.
+
+public:
+    /**
+     * @brief Starts the span.
+     * @param name Name of the span, with static storage duration.
+     */
+    explicit TraceSpan(const char* name);
+
+    /**
+     * @brief Ends the span and records it.
+     */
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+/**
+ * @brief A span covering a whole traversal, held by the iterator that performs it.
+ *
+ * The span starts when the iterator is created and ends when the iterator reports that it
+ * reached the end, or when the last copy of it is destroyed, whichever comes first. Without
+ * TREE_TRACING it holds nothing and does nothing.
+ */
+class TraversalTrace {
+private:
+#ifdef TREE_TRACING
+    mutable std::shared_ptr<TraceSpan> span;  // The running span, shared by copies of the iterator.
+#endif
+
+public:
+    TraversalTrace() = default;
+
+    /**
+     * @brief Starts the span.
+     * @param name Name of the span, with static storage duration.
+     */
+    explicit TraversalTrace(const char* name) {
+#ifdef TREE_TRACING
+        span = std::make_shared<TraceSpan>(name);
+#else
+        (void)name;
+#endif
+    }
+
+    /**
+     * @brief Ends the span, if this is the last iterator holding it.
+     */
+    void end() const {
+#ifdef TREE_TRACING
+        span.reset();
+#endif
+    }
+};
+
+/**
+ * @brief Writes the spans recorded since the last flush as Chrome trace-event JSON.
+ *
+ * The output loads in chrome://tracing and Perfetto. Every thread appears as its own track.
+ *
+ * @param os Output stream.
+ * @return The number of spans written.
+ */
+size_t flush_trace(std::ostream& os);
+
+/**
+ * @brief Writes the spans recorded since the last flush to a JSON file.
+ * @param path Path of the file.
+ * @return The number of spans written.
+ * @throw std::runtime_error if the file cannot be opened.
+ */
+size_t flush_trace(const std::string& path);
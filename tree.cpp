@@ -6,8 +6,14 @@
 
 #include "tree.hpp"
 #include "gui.hpp"
+#include "path_copy.hpp"
+#include "reclaimer.hpp"
+#include "complete_tree.hpp"
+#include "trace.hpp"
 #include <stdexcept>
 #include <stack>
+#include <algorithm>
+#include <unordered_set>
 
 // Default constructor initializes a tree with a maximum degree of 2
 Tree::Tree() : root(nullptr), maxDegree(2) {}
@@ -15,13 +21,162 @@ Tree::Tree() : root(nullptr), maxDegree(2) {}
 // Constructor that allows setting a custom maximum degree for the tree
 Tree::Tree(unsigned int degree) : root(nullptr), maxDegree(degree) {}
 
-// Destructor
+// Destructor releases the nodes without recursing through the children
 Tree::~Tree() {
+    TREE_TRACE_SPAN("Tree::~Tree");
+    pendingReclaim.push_back(std::move(root));
+    reclaim();
+}
+
+// Helper function to link nodes given their children in compressed form: the children of
+// node i are children[offsets[i]] .. children[offsets[i + 1] - 1]
+static Tree link_children(unsigned int degree, size_t rootIndex, const std::vector<size_t>& offsets,
+                          const std::vector<size_t>& children,
+                          const std::vector<std::shared_ptr<BaseNode>>& values) {
+    size_t n = values.size();
+    std::unordered_set<const BaseNode*> seen;
+    seen.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (!values[i]) {
+            throw std::runtime_error("Error: Parent or child node is null!");
+        }
+        // The same node at two indices would be linked under itself or under two parents
+        if (!seen.insert(values[i].get()).second) {
+            throw std::runtime_error("Error: The same node appears more than once!");
+        }
+        // Children the node already has count toward maxDegree
+        if (values[i]->children.size() + (offsets[i + 1] - offsets[i]) > degree) {
+            throw std::runtime_error("Error: Cannot add child, maxDegree exceeded for parent node!");
+        }
+    }
+
+    // Every node must be reachable from the root, otherwise the input has a cycle
+    std::vector<size_t> queue;
+    queue.reserve(n);
+    queue.push_back(rootIndex);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        size_t node = queue[head];
+        queue.insert(queue.end(), children.begin() + static_cast<std::ptrdiff_t>(offsets[node]),
+                     children.begin() + static_cast<std::ptrdiff_t>(offsets[node + 1]));
+    }
+    if (queue.size() != n) {
+        throw std::runtime_error("Error: Not every node is reachable from the root!");
+    }
+
+    // Link with exactly sized children vectors
+    for (size_t i = 0; i < n; ++i) {
+        std::vector<std::shared_ptr<BaseNode>>& list = values[i]->children;
+        list.reserve(list.size() + offsets[i + 1] - offsets[i]);
+        for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+            list.push_back(values[children[k]]);
+        }
+    }
+
+    Tree tree(degree);
+    tree.add_root(values[rootIndex]);
+    return tree;
+}
+
+// Builds a tree from a parent-index array with a counting sort of the nodes by parent
+Tree Tree::from_parent_array(unsigned int degree, const std::vector<long>& parents,
+                             const std::vector<std::shared_ptr<BaseNode>>& values) {
+    TREE_TRACE_SPAN("Tree::from_parent_array");
+    size_t n = values.size();
+    if (parents.size() != n) {
+        throw std::runtime_error("Error: Parent and value arrays differ in size!");
+    }
+    if (n == 0) return Tree(degree);
+
+    // Count the children of every node and find the root
+    std::vector<size_t> offsets(n + 1, 0);
+    size_t rootIndex = n;
+    for (size_t i = 0; i < n; ++i) {
+        if (parents[i] == -1) {
+            if (rootIndex != n) {
+                throw std::runtime_error("Error: Tree has more than one root!");
+            }
+            rootIndex = i;
+        }
+        else if (parents[i] < 0 || static_cast<size_t>(parents[i]) >= n) {
+            throw std::runtime_error("Error: Parent index out of range!");
+        }
+        else {
+            offsets[static_cast<size_t>(parents[i]) + 1]++;
+        }
+    }
+    if (rootIndex == n) {
+        throw std::runtime_error("Error: Tree has no root!");
+    }
+    for (size_t i = 0; i < n; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    // Place every node in its parent's range, in index order
+    std::vector<size_t> children(n - 1);
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        if (i != rootIndex) {
+            children[next[static_cast<size_t>(parents[i])]++] = i;
+        }
+    }
+    return link_children(degree, rootIndex, offsets, children, values);
+}
+
+// Builds a tree from an edge list with a counting sort of the edges by parent
+Tree Tree::from_edges(unsigned int degree, size_t rootIndex,
+                      const std::vector<std::pair<size_t, size_t>>& edges,
+                      const std::vector<std::shared_ptr<BaseNode>>& values) {
+    TREE_TRACE_SPAN("Tree::from_edges");
+    size_t n = values.size();
+    if (n == 0 && edges.empty()) return Tree(degree);
+    if (rootIndex >= n) {
+        throw std::runtime_error("Error: Parent index out of range!");
+    }
+    if (edges.size() != n - 1) {
+        throw std::runtime_error("Error: A tree of n nodes needs exactly n - 1 edges!");
+    }
+
+    // Count the children of every node, rejecting second parents
+    std::vector<size_t> offsets(n + 1, 0);
+    std::vector<bool> hasParent(n, false);
+    hasParent[rootIndex] = true;
+    for (const auto& [parent, child] : edges) {
+        if (parent >= n || child >= n) {
+            throw std::runtime_error("Error: Parent index out of range!");
+        }
+        if (hasParent[child]) {
+            throw std::runtime_error("Error: Node has more than one parent!");
+        }
+        hasParent[child] = true;
+        offsets[parent + 1]++;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    // Place every child in its parent's range, in edge order
+    std::vector<size_t> children(edges.size());
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (const auto& [parent, child] : edges) {
+        children[next[parent]++] = child;
+    }
+    return link_children(degree, rootIndex, offsets, children, values);
 }
 
 // Method to set the root node of the tree
 void Tree::add_root(std::shared_ptr<BaseNode> root_node) {
     root = root_node;
+    cowCopies.clear();
+    privateNodes.clear();
+    cowParents.reset();
+    cowParentChanges.clear();
+    invalidate_indexes();
+    incrementalLca.reset();
+
+    // Re-index the new tree only if lookups were already in use
+    if (valueIndex) {
+        valueIndex = std::make_shared<ValueIndex>(root.get());
+    }
 }
 
 // Method to get the root node of the tree
@@ -29,12 +184,38 @@ BaseNode* Tree::get_root() const {
     return root.get();
 }
 
+// Method to get the maximum degree of the tree
+unsigned int Tree::get_max_degree() const {
+    return maxDegree;
+}
+
 // Method to add a child node to a parent node
 void Tree::add_sub_node(BaseNode* parent, std::shared_ptr<BaseNode> child) {
     if (parent && child) {
-        // Ensure the parent node does not exceed the maximum degree
-        if (parent->children.size() < maxDegree) {
+        // Ensure the parent node does not exceed the maximum degree, before anything is copied
+        if (resolve_node(parent)->children.size() < maxDegree) {
+            // Resolve the parent to this tree's own copy before changing its children
+            if (copyOnWrite) {
+                parent = writable_node(parent);
+                privateNodes.insert(child.get());  // The new child is not shared with any clone
+                cowParentChanges[child.get()] = parent;
+            }
             parent->add_child(child);
+            invalidate_indexes();
+
+            // Keep the incremental LCA index current, or drop it if the parent is outside the tree
+            if (incrementalLca) {
+                if (incrementalLca->contains(parent)) {
+                    unshared(incrementalLca).add_node(parent, child.get());
+                }
+                else {
+                    incrementalLca.reset();
+                }
+            }
+
+            if (valueIndex) {
+                unshared(valueIndex).add_subtree(child.get());
+            }
         }
         else {
             // Throw an error if adding the child would exceed maxDegree
@@ -47,12 +228,423 @@ void Tree::add_sub_node(BaseNode* parent, std::shared_ptr<BaseNode> child) {
     }
 }
 
+// Method to remove a subtree, deferring the release of its nodes
+void Tree::remove_subtree(BaseNode* node) {
+    if (!node) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+    std::shared_ptr<BaseNode> removed = unlink_subtree(resolve_node(node), true);
+    pendingReclaim.push_back(std::move(removed));
+}
+
+// Method to remove a subtree and hand it over to a new tree
+Tree Tree::detach_subtree(BaseNode* node) {
+    if (!node) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+    Tree detached(maxDegree);
+    detached.add_root(unlink_subtree(resolve_node(node), true));
+
+    // The detached nodes may still be shared with a clone of this tree
+    detached.copyOnWrite = copyOnWrite;
+    return detached;
+}
+
+// Method to move a subtree under another node of the same tree
+void Tree::move_subtree(BaseNode* node, BaseNode* newParent) {
+    if (!node || !newParent) {
+        throw std::runtime_error("Error: Parent or child node is null!");
+    }
+    node = resolve_node(node);
+    newParent = resolve_node(newParent);
+    if (node == root.get()) {
+        throw std::runtime_error("Error: Cannot move the root of the tree!");
+    }
+
+    std::vector<size_t> path;
+    if (!find_path(root.get(), node, path) || !find_path(root.get(), newParent, path)) {
+        throw std::runtime_error("Error: Node is not part of the tree!");
+    }
+    if (find_path(node, newParent, path)) {
+        throw std::runtime_error("Error: Cannot move a subtree under itself!");
+    }
+
+    // Moving within the same parent never exceeds the degree
+    bool sameParent = std::any_of(newParent->children.begin(), newParent->children.end(),
+                                  [node](const std::shared_ptr<BaseNode>& child) { return child.get() == node; });
+    if (!sameParent && newParent->children.size() >= maxDegree) {
+        throw std::runtime_error("Error: Cannot add child, maxDegree exceeded for parent node!");
+    }
+
+    // Copy the new parent's path first; it never contains the moved node, so that stays valid
+    BaseNode* target = copyOnWrite ? writable_node(newParent) : newParent;
+    target->add_child(unlink_subtree(node, false));
+    if (copyOnWrite) {
+        cowParentChanges[node] = target;
+    }
+}
+
+// Method to release the removed subtrees
+void Tree::reclaim() {
+    if (backgroundReclaim) {
+        Reclaimer::release(pendingReclaim);
+    }
+    else {
+        release_nodes(pendingReclaim);
+    }
+}
+
+// Method to choose where the nodes are released
+void Tree::set_background_reclaim(bool enabled) {
+    backgroundReclaim = enabled;
+}
+
+// Method to get the number of removed subtrees not released yet
+size_t Tree::pending_reclaim() const {
+    return pendingReclaim.size();
+}
+
+// Method to map a node to this tree's private copy of it, if any
+BaseNode* Tree::resolve_node(BaseNode* node) const {
+    if (copyOnWrite) {
+        auto found = cowCopies.find(node);
+        if (found != cowCopies.end() && !found->second.original.expired()) {
+            return *found->second.slot;
+        }
+    }
+    return node;
+}
+
+// Method to take a subtree out of the tree and return its owning pointer
+std::shared_ptr<BaseNode> Tree::unlink_subtree(BaseNode* node, bool leavesTree) {
+    std::vector<size_t> path;
+    if (!find_path(root.get(), node, path)) {
+        throw std::runtime_error("Error: Node is not part of the tree!");
+    }
+
+    std::shared_ptr<BaseNode> unlinked;
+    if (path.empty()) {
+        unlinked = std::move(root);
+    }
+    else {
+        // Locate the parent, then make it safe to modify
+        BaseNode* parent = root.get();
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            parent = parent->children[path[i]].get();
+        }
+        if (copyOnWrite) {
+            parent = writable_node(parent);
+        }
+        auto position = parent->children.begin() + static_cast<std::ptrdiff_t>(path.back());
+        unlinked = std::move(*position);
+        parent->children.erase(position);
+    }
+
+    invalidate_indexes();
+    incrementalLca.reset();
+
+    // A moved subtree keeps its values and private copies; a removed one takes them along
+    if (leavesTree) {
+        if (valueIndex) {
+            unshared(valueIndex).remove_subtree(unlinked.get());
+        }
+        if (copyOnWrite) {
+            forget_copies(unlinked.get());
+        }
+    }
+    return unlinked;
+}
+
+// Method to drop the copy-on-write entries that point into a removed subtree
+void Tree::forget_copies(BaseNode* node) {
+    std::unordered_set<const BaseNode*> removed;
+    std::vector<BaseNode*> stack = {node};
+    while (!stack.empty()) {
+        BaseNode* current = stack.back();
+        stack.pop_back();
+        removed.insert(current);
+        for (const auto& child : current->children) {
+            stack.push_back(child.get());
+        }
+    }
+    for (const BaseNode* gone : removed) {
+        privateNodes.erase(gone);
+    }
+    for (auto it = cowCopies.begin(); it != cowCopies.end();) {
+        if (removed.count(it->first) || removed.count(*it->second.slot)) {
+            it = cowCopies.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+// Method to get a node that can be modified without affecting any clone
+BaseNode* Tree::writable_node(BaseNode* node) {
+    node = resolve_node(node);
+    if (privateNodes.count(node)) {
+        return node;
+    }
+
+    // Writing to a node outside the tree could change a clone
+    std::vector<size_t> path;
+    if (!cow_path(node, path)) {
+        throw std::runtime_error("Error: Node is not part of the tree!");
+    }
+
+    // Helper to replace a shared node by a private copy, keeping its children shared
+    auto copy_node = [this](std::shared_ptr<BaseNode>& shared) {
+        std::shared_ptr<BaseNode> copy = shared->clone();
+        copy->children = shared->children;
+
+        // Nodes that this one replaced earlier now map to the new copy as well
+        auto found = cowCopies.find(shared.get());
+        bool known = found != cowCopies.end() && !found->second.original.expired();
+        std::shared_ptr<BaseNode*> slot = known ? found->second.slot : std::make_shared<BaseNode*>();
+        *slot = copy.get();
+        cowCopies[shared.get()] = {shared, slot};
+        cowCopies[copy.get()] = {copy, slot};
+        privateNodes.insert(copy.get());
+
+        // Re-key only what points at the replaced node: the children's parent and the value index
+        for (const auto& child : copy->children) {
+            cowParentChanges[child.get()] = copy.get();
+        }
+        if (valueIndex) {
+            unshared(valueIndex).replace_node(shared.get(), copy.get());
+        }
+        shared = std::move(copy);
+    };
+
+    // Copy the shared part of the path; private nodes are already exclusive to this tree
+    if (!privateNodes.count(root.get())) {
+        copy_node(root);
+    }
+    BaseNode* current = root.get();
+    for (size_t index : path) {
+        std::shared_ptr<BaseNode>& child = current->children[index];
+        if (!privateNodes.count(child.get())) {
+            copy_node(child);
+            cowParentChanges[child.get()] = current;
+        }
+        current = child.get();
+    }
+
+    // The binary-lifting LCA index refers to the replaced nodes
+    incrementalLca.reset();
+    return current;
+}
+
+// Method to find a node's path from the root through the parent index
+bool Tree::cow_path(BaseNode* node, std::vector<size_t>& path) {
+    // Helper to walk up from the node, checking every step against the parent's children
+    auto walk = [this, node, &path]() {
+        path.clear();
+        const BaseNode* current = node;
+        while (current != root.get()) {
+            auto changed = cowParentChanges.find(current);
+            BaseNode* parent = nullptr;
+            if (changed != cowParentChanges.end()) {
+                parent = changed->second;
+            }
+            else {
+                auto indexed = cowParents->find(current);
+                if (indexed == cowParents->end()) return false;
+                parent = indexed->second;
+            }
+
+            auto& children = parent->children;
+            auto position = std::find_if(children.begin(), children.end(),
+                                         [current](const std::shared_ptr<BaseNode>& child) { return child.get() == current; });
+            if (position == children.end()) return false;
+            path.push_back(static_cast<size_t>(position - children.begin()));
+            current = parent;
+        }
+        std::reverse(path.begin(), path.end());
+        return true;
+    };
+
+    if (!root) return false;
+    if (!cowParents || cowParentChanges.size() > cowParents->size()) {
+        index_parents();
+    }
+    if (walk()) return true;
+
+    // The index missed a change, such as the children of an added subtree
+    index_parents();
+    return walk();
+}
+
+// Method to index the parent of every node of the tree
+void Tree::index_parents() {
+    auto parents = std::make_shared<std::unordered_map<const BaseNode*, BaseNode*>>();
+    std::vector<BaseNode*> stack;
+    if (root) stack.push_back(root.get());
+    while (!stack.empty()) {
+        BaseNode* current = stack.back();
+        stack.pop_back();
+        for (const auto& child : current->children) {
+            if (!child) {
+                throw std::runtime_error("Error: Encountered null or invalid child node!");
+            }
+            (*parents)[child.get()] = current;
+            stack.push_back(child.get());
+        }
+    }
+    cowParents = std::move(parents);
+    cowParentChanges.clear();
+}
+
+// Method to create a copy-on-write clone sharing all the nodes
+Tree Tree::clone() {
+    // Entries of nodes that no longer exist cannot be looked up any more
+    for (auto it = cowCopies.begin(); it != cowCopies.end();) {
+        it = it->second.original.expired() ? cowCopies.erase(it) : std::next(it);
+    }
+
+    // Index the parents once, before forking, so that every fork shares the index
+    if (!cowParents) {
+        index_parents();
+    }
+    Tree copy(*this);
+
+    // From now on every node is shared, including those this tree had copied privately.
+    // Both trees keep mapping replaced nodes to the copies they share.
+    copyOnWrite = true;
+    privateNodes.clear();
+    copy.copyOnWrite = true;
+    copy.privateNodes.clear();
+    copy.pendingReclaim.clear();
+
+    // The clone needs its own slots, or a later copy in one tree would redirect the other
+    std::unordered_map<BaseNode**, std::shared_ptr<BaseNode*>> slots;
+    for (auto& [node, entry] : copy.cowCopies) {
+        std::shared_ptr<BaseNode*>& own = slots[entry.slot.get()];
+        if (!own) {
+            own = std::make_shared<BaseNode*>(*entry.slot);
+        }
+        entry.slot = own;
+    }
+
+    // The indexes stay shared too; the maintained ones are copied by whichever tree writes first
+    return copy;
+}
+
+// Method to drop the cached indexes after a structural change
+void Tree::invalidate_indexes() {
+    eulerIndex.reset();
+    lcaIndex.reset();
+    levelIndex.reset();
+}
+
+// Method to get the Euler-tour index, building it on first use
+const EulerIndex& Tree::euler_index() const {
+    if (!eulerIndex) {
+        eulerIndex = std::make_shared<const EulerIndex>(root.get());
+    }
+    return *eulerIndex;
+}
+
+// Method to check whether a node is an ancestor of another
+bool Tree::is_ancestor(const BaseNode* ancestor, const BaseNode* descendant) const {
+    return euler_index().is_ancestor(ancestor, descendant);
+}
+
+// Method to get the size of the subtree rooted at a node
+size_t Tree::subtree_size(const BaseNode* node) const {
+    return euler_index().subtree_size(node);
+}
+
+// Method to get the level index, building it on first use
+const LevelIndex& Tree::level_index() const {
+    if (!levelIndex) {
+        levelIndex = std::make_shared<const LevelIndex>(root.get());
+    }
+    return *levelIndex;
+}
+
+// Method to get all the nodes at a given depth
+NodeRange Tree::nodes_at_depth(size_t depth) const {
+    return level_index().nodes_at_depth(depth);
+}
+
+// Method to get the depth of a node
+size_t Tree::depth_of(const BaseNode* node) const {
+    return level_index().depth_of(node);
+}
+
+// Method to get the height of the tree
+size_t Tree::height() const {
+    return level_index().height();
+}
+
+// Method to find the lowest common ancestor of two nodes
+BaseNode* Tree::lca(const BaseNode* a, const BaseNode* b) const {
+    if (!lcaIndex && incrementalLca) {
+        return incrementalLca->lca(a, b);  // Fall back to binary lifting rather than rebuilding
+    }
+    if (!lcaIndex) {
+        euler_index();
+        lcaIndex = std::make_shared<const LcaIndex>(eulerIndex);
+    }
+    return lcaIndex->lca(a, b);
+}
+
+// Method to find the lowest common ancestor of many node pairs at once
+std::vector<BaseNode*> Tree::lca_batch(const std::vector<std::pair<BaseNode*, BaseNode*>>& pairs) const {
+    std::vector<BaseNode*> result;
+    result.reserve(pairs.size());
+    if (pairs.empty()) return result;
+
+    // Resolve the index once for the whole batch
+    result.push_back(lca(pairs[0].first, pairs[0].second));
+    const LcaIndex* table = lcaIndex.get();
+    for (size_t i = 1; i < pairs.size(); ++i) {
+        result.push_back(table ? table->lca(pairs[i].first, pairs[i].second)
+                               : incrementalLca->lca(pairs[i].first, pairs[i].second));
+    }
+    return result;
+}
+
+// Method to start maintaining the binary-lifting LCA index
+void Tree::enable_incremental_lca() {
+    if (!incrementalLca) {
+        incrementalLca = std::make_shared<IncrementalLca>(root.get());
+    }
+}
+
+// Method to get the value index, building it on first use
+const ValueIndex& Tree::value_index() const {
+    if (!valueIndex) {
+        valueIndex = std::make_shared<ValueIndex>(root.get());
+    }
+    return *valueIndex;
+}
+
+// Method to find the nodes holding a value
+const std::vector<BaseNode*>& Tree::find_by_value(const std::string& value) const {
+    return value_index().find(value);
+}
+
+// Method to find the nodes of several values at once
+std::vector<std::vector<BaseNode*>> Tree::find_by_values(const std::vector<std::string>& values) const {
+    const ValueIndex& index = value_index();
+    std::vector<std::vector<BaseNode*>> result;
+    result.reserve(values.size());
+    for (const std::string& value : values) {
+        result.push_back(index.find(value));
+    }
+    return result;
+}
+
 // BFSIterator implementations
 
 // Constructor initializes the iterator with the root node
 Tree::BFSIterator::BFSIterator(BaseNode* root) {
     if (root) {
         queue.push(root);  // Add root to the queue if it is not null
+        trace = TraversalTrace("Tree::bfs");
     }
 }
 
@@ -65,6 +657,10 @@ BaseNode* Tree::BFSIterator::operator*() {
 Tree::BFSIterator& Tree::BFSIterator::operator++() {
     BaseNode* node = queue.front();  // Get the current node
     queue.pop();  // Remove the current node from the queue
+    if (skipChildren) {
+        skipChildren = false;  // Leave the subtree of the current node out
+        return *this;
+    }
     auto& children = node->children;
     for (auto& child : children) {
         if (child != nullptr) {
@@ -78,9 +674,18 @@ Tree::BFSIterator& Tree::BFSIterator::operator++() {
     return *this;
 }
 
+// Marks the children of the current node to be skipped by the next increment
+void Tree::BFSIterator::skip_children() {
+    skipChildren = true;
+}
+
 // Comparison operator checks if the iterator is not at the end
 bool Tree::BFSIterator::operator!=(const BFSIterator& other) const {
-    return !queue.empty();  // The iterators are not equal if the queue is not empty
+    bool more = !queue.empty();  // The iterators are not equal if the queue is not empty
+    if (!more) {
+        trace.end();  // The traversal is over, even if the iterator lives on
+    }
+    return more;
 }
 
 // Returns an iterator to the beginning of the BFS traversal
@@ -110,6 +715,7 @@ Tree::BFSIterator Tree::end() const {
 Tree::DFSIterator::DFSIterator(BaseNode* root) {
     if (root) {
         next.push(root);  // Add root to the stack if it is not null
+        trace = TraversalTrace("Tree::dfs");
     }
 }
 
@@ -122,6 +728,10 @@ BaseNode* Tree::DFSIterator::operator*() {
 Tree::DFSIterator& Tree::DFSIterator::operator++() {
     BaseNode* currentNode = next.top();  // Get the current node
     next.pop();  // Remove the current node from the stack
+    if (skipChildren) {
+        skipChildren = false;  // Leave the subtree of the current node out
+        return *this;
+    }
 
     auto& children = currentNode->children;
     // Add children to the stack in reverse order to maintain DFS order
@@ -137,9 +747,18 @@ Tree::DFSIterator& Tree::DFSIterator::operator++() {
     return *this;
 }
 
+// Marks the children of the current node to be skipped by the next increment
+void Tree::DFSIterator::skip_children() {
+    skipChildren = true;
+}
+
 // Comparison operator checks if the iterator is not at the end
 bool Tree::DFSIterator::operator!=(const DFSIterator& other) const {
-    return !next.empty();  // The iterators are not equal if the stack is not empty
+    bool more = !next.empty();  // The iterators are not equal if the stack is not empty
+    if (!more) {
+        trace.end();  // The traversal is over, even if the iterator lives on
+    }
+    return more;
 }
 
 // Returns an iterator to the beginning of the DFS traversal
@@ -159,6 +778,7 @@ Tree::DFSIterator Tree::end_dfs() const {
 Tree::PreOrderIterator::PreOrderIterator(BaseNode* root, bool useDFS) : useDFS(useDFS) {
     if (root) {
         next.push(root);  // Add root to the stack if it is not null
+        trace = TraversalTrace("Tree::pre_order");
     }
 }
 
@@ -171,6 +791,10 @@ BaseNode* Tree::PreOrderIterator::operator*() {
 Tree::PreOrderIterator& Tree::PreOrderIterator::operator++() {
     BaseNode* currentNode = next.top();  // Get the current node
     next.pop();  // Remove the current node from the stack
+    if (skipChildren) {
+        skipChildren = false;  // Leave the subtree of the current node out
+        return *this;
+    }
 
     auto& children = currentNode->children;
     // Add children to the stack in reverse order to maintain pre-order traversal
@@ -186,9 +810,18 @@ Tree::PreOrderIterator& Tree::PreOrderIterator::operator++() {
     return *this;
 }
 
+// Marks the children of the current node to be skipped by the next increment
+void Tree::PreOrderIterator::skip_children() {
+    skipChildren = true;
+}
+
 // Comparison operator checks if the iterator is not at the end
 bool Tree::PreOrderIterator::operator!=(const PreOrderIterator& other) const {
-    return !next.empty();  // The iterators are not equal if the stack is not empty
+    bool more = !next.empty();  // The iterators are not equal if the stack is not empty
+    if (!more) {
+        trace.end();  // The traversal is over, even if the iterator lives on
+    }
+    return more;
 }
 
 // Returns an iterator to the beginning of the pre-order traversal
@@ -205,6 +838,9 @@ Tree::PreOrderIterator Tree::end_pre_order() const {
 
 // Constructor initializes the iterator with the root node and DFS flag
 Tree::PostOrderIterator::PostOrderIterator(BaseNode* root, bool useDFS) : useDFS(useDFS) {
+    if (root) {
+        trace = TraversalTrace("Tree::post_order");
+    }
     if (useDFS) {
         if (root) {
             dfsStack.push(root);  // Add root to the DFS stack if it is not null
@@ -278,7 +914,11 @@ Tree::PostOrderIterator& Tree::PostOrderIterator::operator++() {
 
 // Comparison operator checks if the iterator is not at the end
 bool Tree::PostOrderIterator::operator!=(const PostOrderIterator& other) const {
-    return !dfsStack.empty();  // The iterators are not equal if the DFS stack is not empty
+    bool more = !dfsStack.empty();  // The iterators are not equal if the DFS stack is not empty
+    if (!more) {
+        trace.end();  // The traversal is over, even if the iterator lives on
+    }
+    return more;
 }
 
 // Returns an iterator to the beginning of the post-order traversal
@@ -297,6 +937,7 @@ Tree::PostOrderIterator Tree::end_post_order() const {
 // Constructor initializes the iterator with the root node and DFS flag
 Tree::InOrderIterator::InOrderIterator(BaseNode* root, bool useDFS) : useDFS(useDFS) {
     if (root) {
+        trace = TraversalTrace("Tree::in_order");
         if (useDFS) {
             next.push(root);  // Add root to the stack if it is not null
         }
@@ -331,7 +972,9 @@ BaseNode* Tree::InOrderIterator::operator*() {
 Tree::InOrderIterator& Tree::InOrderIterator::operator++() {
     BaseNode* currentNode = next.top();
     next.pop();
-    visited.pop();
+    if (!useDFS) {
+        visited.pop();  // Only the in-order walk tracks visited states
+    }
 
     if (useDFS) {
         auto& children = currentNode->children;
@@ -360,7 +1003,11 @@ Tree::InOrderIterator& Tree::InOrderIterator::operator++() {
 
 // Comparison operator checks if the iterator is not at the end
 bool Tree::InOrderIterator::operator!=(const InOrderIterator& other) const {
-    return !next.empty();  // The iterators are not equal if the stack is not empty
+    bool more = !next.empty();  // The iterators are not equal if the stack is not empty
+    if (!more) {
+        trace.end();  // The traversal is over, even if the iterator lives on
+    }
+    return more;
 }
 
 // Returns an iterator to the beginning of the in-order traversal
@@ -373,6 +1020,37 @@ Tree::InOrderIterator Tree::end_in_order() const {
     return InOrderIterator(nullptr, maxDegree > 2);  // Use DFS if maxDegree > 2
 }
 
+// Method to find the first node matching a predicate, skipping the subtrees not to descend into
+BaseNode* Tree::find_first(const std::function<bool(BaseNode*)>& match,
+                           const std::function<bool(BaseNode*)>& descend) const {
+    for (auto it = begin_pre_order(); it != end_pre_order(); ++it) {
+        BaseNode* node = *it;
+        if (match(node)) {
+            return node;
+        }
+        if (descend && !descend(node)) {
+            it.skip_children();
+        }
+    }
+    return nullptr;
+}
+
+// Method to find all the nodes matching a predicate, skipping the subtrees not to descend into
+std::vector<BaseNode*> Tree::find_all(const std::function<bool(BaseNode*)>& match,
+                                      const std::function<bool(BaseNode*)>& descend) const {
+    std::vector<BaseNode*> result;
+    for (auto it = begin_pre_order(); it != end_pre_order(); ++it) {
+        BaseNode* node = *it;
+        if (match(node)) {
+            result.push_back(node);
+        }
+        if (descend && !descend(node)) {
+            it.skip_children();
+        }
+    }
+    return result;
+}
+
 /**
  * @brief Stream insertion operator to print the tree.
  *
@@ -391,81 +1069,40 @@ std::ostream& operator<<(std::ostream& os, const Tree& tree) {
     return os;
 }
 
-// Function to create a min-heap tree from the given tree
-Tree Tree::myHeap() const {
-    if (maxDegree != 2) {
-        throw std::runtime_error("Error: Tree is not a binary tree (maxDegree != 2)");
-    }
+// Method to add up the memory of every node, walking the tree with an explicit stack
+MemoryStats Tree::memory_stats() const {
+    MemoryStats stats;
+    if (!root) return stats;
 
-    // Collect all nodes in BFS order
-    std::vector<BaseNode*> nodes;
-    for (auto it = begin_bfs(); it != end_bfs(); ++it) {
-        nodes.push_back(*it);
-    }
-
-    // Sort nodes based on ASCII value to form a min-heap
-    std::sort(nodes.begin(), nodes.end(), [](BaseNode* a, BaseNode* b) {
-        return a->get_ascii_value() < b->get_ascii_value();
-    });
-
-    // Create a new tree with maxDegree 2
-    Tree heapTree(2);
-    if (nodes.empty()) return heapTree;
-
-    // Use shared_ptr to store the new nodes
-    std::vector<std::shared_ptr<BaseNode>> newNodes;
-    for (BaseNode* node : nodes) {
-        if (auto strNode = dynamic_cast<Node<std::string>*>(node)) {
-            newNodes.push_back(std::make_shared<Node<std::string>>(strNode->value));
-        }
-        else if (auto intNode = dynamic_cast<Node<int>*>(node)) {
-            newNodes.push_back(std::make_shared<Node<int>>(intNode->value));
-        }
-        else if (auto doubleNode = dynamic_cast<Node<double>*>(node)) {
-            newNodes.push_back(std::make_shared<Node<double>>(doubleNode->value));
-        }
-        else if (auto complexNode1 = dynamic_cast<Node<Complex<int, double>>*>(node)) {
-            newNodes.push_back(std::make_shared<Node<Complex<int, double>>>(complexNode1->value));
-        }
-        else if (auto complexNode2 = dynamic_cast<Node<Complex<double, int>>*>(node)) {
-            newNodes.push_back(std::make_shared<Node<Complex<double, int>>>(complexNode2->value));
-        }
-        else if (auto complexNode3 = dynamic_cast<Node<Complex<double, double>>*>(node)) {
-            newNodes.push_back(std::make_shared<Node<Complex<double, double>>>(complexNode3->value));
-        }
-        else if (auto complexNode4 = dynamic_cast<Node<Complex<int, int>>*>(node)) {
-            newNodes.push_back(std::make_shared<Node<Complex<int, int>>>(complexNode4->value));
+    std::vector<const BaseNode*> stack = {root.get()};
+    while (!stack.empty()) {
+        const BaseNode* node = stack.back();
+        stack.pop_back();
+
+        stats.nodes++;
+        stats.nodeBytes += node->node_bytes();
+        stats.controlBlockBytes += node->control_block_bytes();
+        stats.childArrayUsedBytes += node->children.size() * sizeof(std::shared_ptr<BaseNode>);
+        stats.childArrayBytes += node->children.capacity() * sizeof(std::shared_ptr<BaseNode>);
+        stats.valueBytes += node->value_heap_bytes();
+
+        for (const auto& child : node->children) {
+            if (!child) {
+                throw std::runtime_error("Error: Encountered null or invalid child node!");
+            }
+            stack.push_back(child.get());
         }
-
     }
+    return stats;
+}
 
-    // Add root node
-    heapTree.add_root(newNodes[0]);
-
-    // Use a queue to build the tree level by level
-    std::queue<BaseNode*> queue;
-    queue.push(newNodes[0].get());
-
-    size_t index = 1;
-    while (index < newNodes.size()) {
-        BaseNode* current = queue.front();
-        queue.pop();
-
-        // Add left child
-        if (index < newNodes.size()) {
-            heapTree.add_sub_node(current, newNodes[index]);
-            queue.push(newNodes[index].get());
-            index++;
-        }
-
-        // Add right child
-        if (index < newNodes.size()) {
-            heapTree.add_sub_node(current, newNodes[index]);
-            queue.push(newNodes[index].get());
-            index++;
-        }
+// Function to create a k-ary min-heap tree from the given tree, k being maxDegree
+Tree Tree::myHeap() const {
+    TREE_TRACE_SPAN("Tree::myHeap");
+    if (maxDegree == 0) {
+        throw std::runtime_error("Error: Heap arity must be at least 1!");  // A heap node needs room for children
     }
 
-    // Return the heap
-    return heapTree;
+    // Order the nodes as an implicit k-ary heap, then copy it into a pointer-based tree
+    return CompleteTree::min_heap(*this).to_tree();
 }
@@ -7,10 +7,19 @@
 #pragma once
 
 #include "node.hpp"
+#include "euler_index.hpp"
+#include "lca.hpp"
+#include "value_index.hpp"
+#include "level_index.hpp"
+#include "trace.hpp"
+#include "memory_stats.hpp"
 #include <vector>
 #include <queue>
 #include <stack>
 #include <iostream>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 /**
  * @brief Class representing a generic tree structure.
@@ -20,6 +29,101 @@ private:
     std::shared_ptr<BaseNode> root;  // Pointer to the root node of the tree.
     unsigned int maxDegree;          // Maximum number of children each node can have.
 
+    mutable std::shared_ptr<const EulerIndex> eulerIndex;  // Lazily built interval index, reset on mutation.
+    mutable std::shared_ptr<const LcaIndex> lcaIndex;      // Lazily built sparse-table LCA index, reset on mutation.
+    mutable std::shared_ptr<const LevelIndex> levelIndex;  // Lazily built level index, reset on mutation.
+    std::shared_ptr<IncrementalLca> incrementalLca;        // Binary-lifting LCA index, extended on add_sub_node, shared with clones until written.
+    mutable std::shared_ptr<ValueIndex> valueIndex;        // Value to nodes index, built on first lookup then maintained, shared with clones until written.
+
+    /**
+     * @brief Where a node replaced by a private copy went. Every node that was ever replaced
+     * shares the slot of its latest copy, so one lookup finds the copy now in the tree.
+     */
+    struct CowCopy {
+        std::weak_ptr<BaseNode> original;   // The replaced node; an expired one no longer maps anything.
+        std::shared_ptr<BaseNode*> slot;    // The copy now in the tree.
+    };
+
+    bool copyOnWrite = false;  // Whether the nodes may be shared with a clone.
+    std::unordered_map<const BaseNode*, CowCopy> cowCopies;  // Replaced node, or its latest copy, to that copy.
+    std::unordered_set<const BaseNode*> privateNodes;        // Nodes of this tree not shared with any clone.
+    std::shared_ptr<const std::unordered_map<const BaseNode*, BaseNode*>> cowParents;  // Parent of every node when last indexed, shared with clones.
+    std::unordered_map<const BaseNode*, BaseNode*> cowParentChanges;  // Parents set in this tree since then.
+    std::vector<std::shared_ptr<BaseNode>> pendingReclaim;  // Removed subtrees, released together by reclaim().
+    bool backgroundReclaim = false;  // Whether nodes are released on the reclaimer thread.
+
+    /**
+     * @brief Drops every cached index after the structure of the tree changed.
+     */
+    void invalidate_indexes();
+
+    /**
+     * @brief Gets a maintained index that is safe to update, copying it first if a clone shares it.
+     * @tparam Index The type of the index.
+     * @param index The index of this tree; it must not be null.
+     * @return The index, owned by this tree alone.
+     */
+    template <typename Index>
+    static Index& unshared(std::shared_ptr<Index>& index) {
+        if (index.use_count() > 1) {
+            index = std::make_shared<Index>(*index);
+        }
+        return *index;
+    }
+
+    /**
+     * @brief Gets a version of a node that is safe to modify in place.
+     *
+     * Without copy-on-write this is the node itself. Otherwise the nodes on the path from
+     * the root to the node that are still shared with a clone are copied first.
+     *
+     * @param node A node of the tree, or a node it replaced with a copy.
+     * @return The node, or its private copy.
+     * @throw std::runtime_error if copy-on-write is on and the node is not part of the tree.
+     */
+    BaseNode* writable_node(BaseNode* node);
+
+    /**
+     * @brief Finds the child indices leading from the root to a node by walking up its parents.
+     *
+     * Parents come from an index built once and shared with clones, plus the changes made
+     * since, so a write costs O(depth * maxDegree). The index is rebuilt only when a walk
+     * fails or the changes outgrow it.
+     *
+     * @param node The node.
+     * @param path Filled with the index of the child taken at each step.
+     * @return True if the node is part of the tree.
+     */
+    bool cow_path(BaseNode* node, std::vector<size_t>& path);
+
+    /**
+     * @brief Rebuilds the parent index used by cow_path.
+     * @throw std::runtime_error if a null child is encountered.
+     */
+    void index_parents();
+
+    /**
+     * @brief Maps a node passed by the caller to the node that is actually part of this tree.
+     * @param node A node of the tree, or a node of a clone that this tree copied.
+     * @return The node of this tree.
+     */
+    BaseNode* resolve_node(BaseNode* node) const;
+
+    /**
+     * @brief Unlinks a subtree from its parent, copying the shared part of the path first.
+     * @param node A node of the tree, resolved with resolve_node.
+     * @param leavesTree Whether the subtree leaves the tree, rather than moving within it.
+     * @return The owning pointer to the unlinked subtree.
+     * @throw std::runtime_error if the node is not part of the tree.
+     */
+    std::shared_ptr<BaseNode> unlink_subtree(BaseNode* node, bool leavesTree);
+
+    /**
+     * @brief Drops the copy-on-write entries of a subtree that left the tree.
+     * @param node The root of the subtree.
+     */
+    void forget_copies(BaseNode* node);
+
 public:
     /**
      * @brief Default constructor initializes the tree with a maximum degree of 2.
@@ -34,9 +138,48 @@ public:
 
     /**
      * @brief Destructor to clean up the tree.
+     *
+     * The nodes are released iteratively, so even a path-like tree of any depth cannot
+     * overflow the stack. With background reclamation enabled, the release happens on the
+     * reclaimer thread instead of the caller's.
      */
     ~Tree();
 
+    /**
+     * @brief Builds a whole tree from a parent-index array in O(n).
+     *
+     * Node i holds values[i] and is a child of parents[i]; the root has parent -1.
+     * Children keep the order of their indices. A counting pass sizes every children
+     * vector exactly, so no vector is reallocated while linking.
+     *
+     * @param degree Maximum number of children each node can have.
+     * @param parents The parent index of every node, -1 for the root.
+     * @param values The node of every index.
+     * @return The built tree.
+     * @throw std::runtime_error if a node is null or appears twice, the sizes differ, there is
+     * not exactly one root, an index is out of range, a node would have too many children
+     * (counting those it already has) or not every node is reachable from the root.
+     */
+    static Tree from_parent_array(unsigned int degree, const std::vector<long>& parents,
+                                  const std::vector<std::shared_ptr<BaseNode>>& values);
+
+    /**
+     * @brief Builds a whole tree from an edge list in O(n).
+     *
+     * Children keep the order in which their edges appear.
+     *
+     * @param degree Maximum number of children each node can have.
+     * @param rootIndex The index of the root.
+     * @param edges The (parent, child) index pairs.
+     * @param values The node of every index.
+     * @return The built tree.
+     * @throw std::runtime_error under the same conditions as from_parent_array, or if a
+     * node has two parents.
+     */
+    static Tree from_edges(unsigned int degree, size_t rootIndex,
+                           const std::vector<std::pair<size_t, size_t>>& edges,
+                           const std::vector<std::shared_ptr<BaseNode>>& values);
+
     /**
      * @brief Sets the root node of the tree.
      * @param root_node Pointer to the root node.
@@ -49,6 +192,12 @@ public:
      */
     BaseNode* get_root() const;
 
+    /**
+     * @brief Gets the maximum number of children each node can have.
+     * @return The maximum degree of the tree.
+     */
+    unsigned int get_max_degree() const;
+
     /**
      * @brief Adds a child node to a parent node.
      * @param parent Pointer to the parent node.
@@ -57,12 +206,187 @@ public:
      */
     void add_sub_node(BaseNode* parent, std::shared_ptr<BaseNode> child);
 
+    /**
+     * @brief Removes a node and every node below it from the tree.
+     *
+     * Finding the node searches the tree from the root, and the value index and copy
+     * bookkeeping visit every removed node, so a prune costs O(n). What is deferred is
+     * the release: the removed nodes are kept until reclaim() is called, so their
+     * destructors do not run inside the prune.
+     *
+     * @param node The root of the subtree to remove. Removing the root empties the tree.
+     * @throw std::runtime_error if the node is null or not part of the tree.
+     */
+    void remove_subtree(BaseNode* node);
+
+    /**
+     * @brief Removes a node and every node below it and returns them as a tree of their own.
+     * @param node The root of the subtree to detach.
+     * @return A tree with the same maximum degree rooted at the node.
+     * @throw std::runtime_error if the node is null or not part of the tree.
+     */
+    Tree detach_subtree(BaseNode* node);
+
+    /**
+     * @brief Moves a node and every node below it under a new parent, as its last child.
+     *
+     * Both nodes are located by a search from the root, so a move costs O(n).
+     *
+     * @param node The root of the subtree to move.
+     * @param newParent The node to attach it to.
+     * @throw std::runtime_error if a node is null or not part of the tree, if the node is
+     * the root, if the new parent lies inside the moved subtree or if the new parent has
+     * reached the maximum number of children.
+     */
+    void move_subtree(BaseNode* node, BaseNode* newParent);
+
+    /**
+     * @brief Frees the subtrees removed since the last call.
+     */
+    void reclaim();
+
+    /**
+     * @brief Chooses whether the destructor and reclaim() release nodes on a background thread.
+     * @param enabled True to hand the nodes to the shared Reclaimer, false to release them inline.
+     */
+    void set_background_reclaim(bool enabled);
+
+    /**
+     * @brief Gets the number of removed subtrees waiting for reclaim().
+     * @return The number of pending subtrees.
+     */
+    size_t pending_reclaim() const;
+
+    /**
+     * @brief Gets the Euler-tour index of the tree, building it on first use.
+     *
+     * The index is cached until the tree is changed through add_root or add_sub_node.
+     * Adding children directly through BaseNode::add_child bypasses the invalidation.
+     *
+     * @return Reference to the index, valid until the next mutation of the tree.
+     */
+    const EulerIndex& euler_index() const;
+
+    /**
+     * @brief Checks whether one node is an ancestor of another. A node is its own ancestor.
+     * @param ancestor The candidate ancestor.
+     * @param descendant The candidate descendant.
+     * @return True if ancestor lies on the path from the root to descendant.
+     * @throw std::runtime_error if either node is not in the tree.
+     */
+    bool is_ancestor(const BaseNode* ancestor, const BaseNode* descendant) const;
+
+    /**
+     * @brief Gets the number of nodes in the subtree rooted at a node, the node included.
+     * @param node The root of the subtree.
+     * @return The size of the subtree.
+     * @throw std::runtime_error if the node is not in the tree.
+     */
+    size_t subtree_size(const BaseNode* node) const;
+
+    /**
+     * @brief Gets the level index of the tree, building it on first use.
+     *
+     * Like euler_index(), the index is cached until add_root or add_sub_node is called.
+     *
+     * @return Reference to the index, valid until the next mutation of the tree.
+     */
+    const LevelIndex& level_index() const;
+
+    /**
+     * @brief Gets all the nodes at a given depth, left to right.
+     * @param depth The depth of the level (the root is at depth 0).
+     * @return The nodes of the level, empty if the tree is not that deep. Valid until the next mutation.
+     */
+    NodeRange nodes_at_depth(size_t depth) const;
+
+    /**
+     * @brief Gets the depth of a node.
+     * @param node The node to look up.
+     * @return The depth of the node (the root is at depth 0).
+     * @throw std::runtime_error if the node is not in the tree.
+     */
+    size_t depth_of(const BaseNode* node) const;
+
+    /**
+     * @brief Gets the height of the tree, the number of edges on its longest downward path.
+     * @return The height, 0 for an empty or single node tree.
+     */
+    size_t height() const;
+
+    /**
+     * @brief Finds the lowest common ancestor of two nodes.
+     *
+     * Answers in O(1) from a sparse table built lazily in O(n log n). When the table was
+     * dropped by a mutation and the incremental index is enabled, the query falls back
+     * to binary lifting in O(log n) instead of rebuilding the table.
+     *
+     * @param a The first node.
+     * @param b The second node.
+     * @return The lowest common ancestor of a and b.
+     * @throw std::runtime_error if either node is not in the tree.
+     */
+    BaseNode* lca(const BaseNode* a, const BaseNode* b) const;
+
+    /**
+     * @brief Finds the lowest common ancestor of every pair of nodes.
+     * @param pairs The node pairs to query.
+     * @return The lowest common ancestor of each pair, in the same order.
+     * @throw std::runtime_error if a node is not in the tree.
+     */
+    std::vector<BaseNode*> lca_batch(const std::vector<std::pair<BaseNode*, BaseNode*>>& pairs) const;
+
+    /**
+     * @brief Builds the binary-lifting LCA index and keeps it current on every add_sub_node.
+     *
+     * Meant for trees that keep growing between LCA queries. Adding a child under a node
+     * that is not in the tree drops the index again.
+     */
+    void enable_incremental_lca();
+
+    /**
+     * @brief Finds the nodes whose value, as returned by get_value(), equals a string.
+     *
+     * The first lookup builds a hash index over the tree. From then on add_root and
+     * add_sub_node keep it current, so later lookups are O(1) on average.
+     *
+     * @param value The value to look up.
+     * @return The matching nodes, in the order they were indexed. Valid until the next mutation.
+     */
+    const std::vector<BaseNode*>& find_by_value(const std::string& value) const;
+
+    /**
+     * @brief Finds the nodes of several values at once.
+     * @param values The values to look up.
+     * @return The matching nodes of each value, in the same order.
+     */
+    std::vector<std::vector<BaseNode*>> find_by_values(const std::vector<std::string>& values) const;
+
+    /**
+     * @brief Finds the nodes of type Node<T> holding a value, using the same index.
+     * @tparam T The type of the value.
+     * @param value The value to look up.
+     * @return The matching nodes, in the order they were indexed.
+     */
+    template <typename T>
+    std::vector<BaseNode*> find_typed(const T& value) const {
+        return value_index().find_typed(value);
+    }
+
+    /**
+     * @brief Gets the value index of the tree, building it on first use.
+     * @return Reference to the index.
+     */
+    const ValueIndex& value_index() const;
+
     /**
      * @brief BFS (Breadth-First Search) iterator class for traversing the tree.
      */
     class BFSIterator {
     private:
         std::queue<BaseNode*> queue;  // Queue to manage the BFS traversal.
+        bool skipChildren = false;    // Flag to leave out the children of the current node.
+        TraversalTrace trace;         // Span covering the traversal, when tracing is compiled in.
 
     public:
         /**
@@ -83,6 +407,12 @@ public:
          */
         BFSIterator& operator++();
 
+        /**
+         * @brief Makes the next increment leave out the children of the current node,
+         * so its subtree is never visited.
+         */
+        void skip_children();
+
         /**
          * @brief Comparison operator to check if the iterator is not at the end.
          * @param other Another BFS iterator to compare with.
@@ -121,6 +451,8 @@ public:
     class DFSIterator {
     private:
         std::stack<BaseNode*> next;  // Stack to manage the DFS traversal.
+        bool skipChildren = false;   // Flag to leave out the children of the current node.
+        TraversalTrace trace;        // Span covering the traversal, when tracing is compiled in.
 
     public:
         /**
@@ -141,6 +473,12 @@ public:
          */
         DFSIterator& operator++();
 
+        /**
+         * @brief Makes the next increment leave out the children of the current node,
+         * so its subtree is never visited.
+         */
+        void skip_children();
+
         /**
          * @brief Comparison operator to check if the iterator is not at the end.
          * @param other Another DFS iterator to compare with.
@@ -168,6 +506,8 @@ public:
     private:
         std::stack<BaseNode*> next;  // Stack to manage the pre-order traversal.
         bool useDFS;  // Flag to determine whether to use DFS.
+        bool skipChildren = false;  // Flag to leave out the children of the current node.
+        TraversalTrace trace;  // Span covering the traversal, when tracing is compiled in.
 
     public:
         /**
@@ -189,6 +529,12 @@ public:
          */
         PreOrderIterator& operator++();
 
+        /**
+         * @brief Makes the next increment leave out the children of the current node,
+         * so its subtree is never visited.
+         */
+        void skip_children();
+
         /**
          * @brief Comparison operator to check if the iterator is not at the end.
          * @param other Another PreOrder iterator to compare with.
@@ -217,6 +563,7 @@ public:
         std::stack<std::pair<BaseNode*, bool>> stack;  // Stack to manage the post-order traversal.
         std::stack<BaseNode*> dfsStack;  // Stack to manage DFS traversal.
         bool useDFS;  // Flag to determine whether to use DFS.
+        TraversalTrace trace;  // Span covering the traversal, when tracing is compiled in.
 
         /**
          * @brief Helper method to expand the stack for post-order traversal.
@@ -271,6 +618,7 @@ public:
         std::stack<BaseNode*> next;  // Stack to manage the in-order traversal.
         std::stack<bool> visited;  // Stack to manage the visited state of nodes.
         bool useDFS;  // Flag to determine whether to use DFS.
+        TraversalTrace trace;  // Span covering the traversal, when tracing is compiled in.
 
         /**
          * @brief Helper method to push left children onto the stack for in-order traversal.
@@ -319,6 +667,29 @@ public:
     InOrderIterator end_in_order() const;
 
 
+    /**
+     * @brief Finds the first node, in pre-order, matching a predicate.
+     *
+     * The search stops at the first match. Subtrees can be left out of the search by
+     * passing a descend predicate: the children of a node are only searched when it
+     * returns true for that node.
+     *
+     * @param match The predicate the node must match.
+     * @param descend Optional predicate deciding whether to search below a node.
+     * @return The first matching node, or nullptr if there is none.
+     */
+    BaseNode* find_first(const std::function<bool(BaseNode*)>& match,
+                         const std::function<bool(BaseNode*)>& descend = nullptr) const;
+
+    /**
+     * @brief Finds all the nodes, in pre-order, matching a predicate.
+     * @param match The predicate the nodes must match.
+     * @param descend Optional predicate deciding whether to search below a node.
+     * @return The matching nodes.
+     */
+    std::vector<BaseNode*> find_all(const std::function<bool(BaseNode*)>& match,
+                                    const std::function<bool(BaseNode*)>& descend = nullptr) const;
+
     /**
      * @brief Stream insertion operator to print the tree.
      *
@@ -333,10 +704,49 @@ public:
      */
     friend std::ostream& operator<<(std::ostream& os, const Tree& tree);
 
+    /**
+     * @brief CompleteTree converts from and to Tree, so it shares the root pointer directly.
+     */
+    friend class CompleteTree;
+
+
+    /**
+     * @brief Creates a copy of the tree that shares all of its nodes until one of the two changes.
+     *
+     * After cloning, both trees are copy-on-write: add_sub_node first copies the nodes on
+     * the path from the root to the parent that are still shared, and only then attaches
+     * the child, so the other tree never sees the change. The nodes passed to add_sub_node
+     * may still be the original ones; they are mapped to their copies, across any number of
+     * clones. A node of neither tree is rejected rather than modified. The maintained
+     * value and LCA indexes are shared as well, and copied by the first tree to update them.
+     *
+     * Not const: this tree becomes copy-on-write too, and its own copies become shared.
+     *
+     * @return The clone.
+     */
+    Tree clone();
+
+    /**
+     * @brief Walks the tree once and adds up the memory its nodes occupy.
+     *
+     * Sizes are those requested from the allocator; allocator headers are not included.
+     * Control blocks are counted as make_shared lays them out, and the cached indexes
+     * are not counted.
+     *
+     * @return The memory by category.
+     * @throw std::runtime_error if a null child is encountered.
+     */
+    MemoryStats memory_stats() const;
 
     /**
      * @brief Method to convert the tree into a min-heap.
-     * @return A new tree that is a min-heap.
+     *
+     * The heap has the tree's maxDegree k as arity. Nodes are ordered by the ASCII sum of
+     * their values and laid out as an implicit array: the children of the i-th node in BFS
+     * order are the nodes k*i+1 .. k*i+k, so the heap is complete and as shallow as possible.
+     *
+     * @return A new tree that is a k-ary min-heap.
+     * @throw std::runtime_error if maxDegree is 0, which leaves no arity for the heap.
      */
     Tree myHeap() const;
 };
@@ -0,0 +1,71 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#include "value_index.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+// Indexes the whole tree
+ValueIndex::ValueIndex(BaseNode* root) {
+    if (root) {
+        add_subtree(root);
+    }
+}
+
+// Walks the subtree in pre-order and files every node under its value
+void ValueIndex::add_subtree(BaseNode* node) {
+    std::vector<BaseNode*> stack = {node};
+    while (!stack.empty()) {
+        BaseNode* current = stack.back();
+        stack.pop_back();
+        buckets[current->get_value()].push_back(current);
+
+        auto& children = current->children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            if (*it == nullptr) {
+                throw std::runtime_error("Error: Encountered null or invalid child node!");
+            }
+            stack.push_back(it->get());
+        }
+    }
+}
+
+// Walks the subtree and takes every node out of its bucket, keeping the order of the rest
+void ValueIndex::remove_subtree(BaseNode* node) {
+    std::vector<BaseNode*> stack = {node};
+    while (!stack.empty()) {
+        BaseNode* current = stack.back();
+        stack.pop_back();
+        auto bucket = buckets.find(current->get_value());
+        if (bucket != buckets.end()) {
+            auto& nodes = bucket->second;
+            nodes.erase(std::remove(nodes.begin(), nodes.end(), current), nodes.end());
+            if (nodes.empty()) {
+                buckets.erase(bucket);
+            }
+        }
+        for (const auto& child : current->children) {
+            if (child) {
+                stack.push_back(child.get());
+            }
+        }
+    }
+}
+
+// Swaps the pointer in the copy's bucket; the value, and so the bucket, are the same
+void ValueIndex::replace_node(const BaseNode* node, BaseNode* copy) {
+    auto bucket = buckets.find(copy->get_value());
+    if (bucket != buckets.end()) {
+        std::replace(bucket->second.begin(), bucket->second.end(), const_cast<BaseNode*>(node), copy);
+    }
+}
+
+// Looks up a single value
+const std::vector<BaseNode*>& ValueIndex::find(const std::string& value) const {
+    static const std::vector<BaseNode*> none;
+    auto it = buckets.find(value);
+    return it == buckets.end() ? none : it->second;
+}
@@ -0,0 +1,81 @@
+/*
+ * Author: Sapir Dahan
+ * ID: 325732972
+ * Mail: sapirdahan2003@gmail.com
+ */
+
+#pragma once
+
+#include "node.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @class ValueIndex
+ * @brief Hash index from a node's value, as returned by get_value(), to the nodes holding it.
+ *
+ * Nodes are listed per value in the order they were indexed. Typed lookups share the
+ * same buckets and keep only the nodes whose stored type matches.
+ */
+class ValueIndex {
+private:
+    std::unordered_map<std::string, std::vector<BaseNode*>> buckets;  // Nodes grouped by value.
+
+public:
+    /**
+     * @brief Indexes every node of a tree.
+     * @param root Pointer to the root node (may be null).
+     * @throw std::runtime_error if a null child is encountered.
+     */
+    explicit ValueIndex(BaseNode* root);
+
+    /**
+     * @brief Indexes a node and every node below it.
+     * @param node The root of the subtree to add.
+     * @throw std::runtime_error if a null child is encountered.
+     */
+    void add_subtree(BaseNode* node);
+
+    /**
+     * @brief Removes a node and every node below it from the index.
+     * @param node The root of the subtree to remove.
+     */
+    void remove_subtree(BaseNode* node);
+
+    /**
+     * @brief Puts a copy of a node in the node's place, keeping the order of its bucket.
+     * @param node The indexed node.
+     * @param copy The copy, holding the same value.
+     */
+    void replace_node(const BaseNode* node, BaseNode* copy);
+
+    /**
+     * @brief Finds the nodes whose value is the given string.
+     * @param value The value to look up.
+     * @return The matching nodes, empty if there are none.
+     */
+    const std::vector<BaseNode*>& find(const std::string& value) const;
+
+    /**
+     * @brief Finds the nodes of type Node<T> holding the given value.
+     *
+     * The string bucket only narrows the search: values that print the same, such as
+     * doubles rounded to the same digits, are told apart by comparing the stored values.
+     *
+     * @tparam T The type of the value; it must support operator==.
+     * @param value The value to look up.
+     * @return The matching nodes.
+     */
+    template <typename T>
+    std::vector<BaseNode*> find_typed(const T& value) const {
+        std::vector<BaseNode*> result;
+        for (BaseNode* node : find(Node<T>(value).get_value())) {
+            auto typed = dynamic_cast<const Node<T>*>(node);
+            if (typed && typed->value == value) {
+                result.push_back(node);
+            }
+        }
+        return result;
+    }
+};